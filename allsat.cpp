@@ -0,0 +1,105 @@
+#include "allsat.hpp"
+
+namespace logic {
+	ModelEnumerator::ModelEnumerator(const Formula& _formula, EnumerationOptions options)
+		: formula(_formula), partial(options.partial), solver(_formula) {
+		auto& names = options.projection.empty() ? formula.get_variables() : options.projection;
+		for (const auto & name : names) {
+			/* a projected variable the clauses never mention must still show up in models */
+			solver.declare(name);
+			projection.push_back(VariableTable::intern(name));
+		}
+
+		/* start from the cube covering everything */
+		pending.emplace_back();
+	}
+
+	Interpretation ModelEnumerator::shrink(const Interpretation& prefix, const Interpretation& model) const {
+		/* variables outside the projection keep their witness valuation */
+		auto assignment = model;
+		for (auto index : projection) {
+			if (prefix.contains(index)) continue;
+
+			bool valuation = assignment.at(index);
+			assignment.erase(index);
+			if (formula.eval_partial(assignment) != true) assignment.set(index, valuation);
+		}
+
+		Interpretation cube;
+		for (auto index : projection) {
+			if (assignment.contains(index)) cube.set(index, assignment.at(index));
+		}
+
+		return cube;
+	}
+
+	std::optional<Interpretation> ModelEnumerator::next() {
+		while (not pending.empty()) {
+			auto prefix = std::move(pending.back());
+			pending.pop_back();
+
+			auto model = solver.solve(prefix);
+			if (not model.has_value()) continue;
+
+			Interpretation cube;
+			if (partial) {
+				cube = shrink(prefix, *model);
+			} else {
+				for (auto index : projection) cube.set(index, model->at(index));
+			}
+
+			/* what is left of the prefix's cube, as disjoint cubes each one literal longer than the last */
+			auto branch = prefix;
+			for (auto index : projection) {
+				if (not cube.contains(index) || prefix.contains(index)) continue;
+
+				bool valuation = cube.at(index);
+				pending.push_back(branch);
+				pending.back().set(index, not valuation);
+				branch.set(index, valuation);
+			}
+
+			return cube;
+		}
+
+		return std::nullopt;
+	}
+
+	std::size_t ModelEnumerator::for_each(const std::function<bool(const Interpretation&)>& visit) {
+		std::size_t visited = 0;
+		while (auto model = next()) {
+			visited++;
+			if (not visit(*model)) break;
+		}
+
+		return visited;
+	}
+
+	ModelEnumerator::iterator ModelEnumerator::begin() {
+		return iterator(this);
+	}
+
+	std::default_sentinel_t ModelEnumerator::end() const {
+		return std::default_sentinel;
+	}
+
+	ModelEnumerator::iterator::iterator(ModelEnumerator* _enumerator)
+		: enumerator(_enumerator), current(_enumerator->next()) { }
+
+	const Interpretation& ModelEnumerator::iterator::operator*() const {
+		return *current;
+	}
+
+	const Interpretation* ModelEnumerator::iterator::operator->() const {
+		return &*current;
+	}
+
+	ModelEnumerator::iterator& ModelEnumerator::iterator::operator++() {
+		current = enumerator->next();
+		return *this;
+	}
+
+	void ModelEnumerator::iterator::operator++(int) {
+		++*this;
+	}
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "formula.hpp"
+#include "solver.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace logic {
+	struct EnumerationOptions {
+		/* the variables models are reported over, empty for every variable of the formula */
+		std::vector<std::string> projection;
+		/* report cubes - partial models whose every extension is a model */
+		bool partial = false;
+	};
+
+	/*
+	 * lazy enumeration of the models of a formula (AllSAT)
+	 *
+	 * Models are found by the incremental solver under assumptions rather than by
+	 * scanning rows, so there is no limit on the number of variables. Each answer splits
+	 * the cube it was found in, the rest of which is queued as disjoint cubes, so every
+	 * model is reported exactly once and no blocking clauses are added. At most one
+	 * cube per projected variable is ever pending, each covering the range of the
+	 * projected variables. The rest of the memory is the solver's, whose learnt
+	 * clauses are reduced regularly and whose limit on them only grows slowly with
+	 * the number of conflicts - so it doesn't grow with the number of models.
+	 *
+	 * With a projection, variables outside it are existentially quantified - each
+	 * assignment of the projected variables that extends to a model is reported once.
+	 */
+	class ModelEnumerator {
+		Formula formula;
+		bool partial;
+		std::vector<std::size_t> projection;
+
+		Solver solver;
+		/* assumptions describing the cubes still to be searched, the smallest last */
+		std::vector<Interpretation> pending;
+
+		/* the smallest extension of prefix, within model, which still satisfies the formula */
+		Interpretation shrink(const Interpretation& prefix, const Interpretation& model) const;
+
+	public:
+		class iterator {
+			ModelEnumerator* enumerator = nullptr;
+			std::optional<Interpretation> current;
+
+		public:
+			using value_type = Interpretation;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+			iterator(ModelEnumerator*);
+
+			const Interpretation& operator*() const;
+			const Interpretation* operator->() const;
+			iterator& operator++();
+			void operator++(int);
+
+			friend bool operator==(const iterator& it, std::default_sentinel_t) {
+				return not it.current.has_value();
+			}
+		};
+
+		ModelEnumerator(const Formula&, EnumerationOptions = {});
+
+		/* the next model, empty once every model has been reported */
+		std::optional<Interpretation> next();
+
+		/* call visit with each remaining model until it returns false, gives the number visited */
+		std::size_t for_each(const std::function<bool(const Interpretation&)>& visit);
+
+		/* single pass iteration over the remaining models */
+		iterator begin();
+		std::default_sentinel_t end() const;
+	};
+}
@@ -0,0 +1,279 @@
+#include "anf.hpp"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace logic {
+	namespace {
+		void set_monomial(std::vector<std::uint64_t>& coefficients, std::uint64_t monomial) {
+			coefficients[monomial / 64] |= std::uint64_t(1) << (monomial % 64);
+		}
+	}
+
+	ANF::ANF(std::vector<std::string> _variables, std::vector<std::uint64_t> _coefficients)
+		: variables(std::move(_variables)), coefficients(std::move(_coefficients)) { }
+
+	ANF::ANF(const TruthTable& table) : variables(table.get_variables()), coefficients(table.get_rows()) {
+		mobius_transform(coefficients, variables.size());
+	}
+
+	ANF::ANF(const Formula& formula) : variables(formula.variables) {
+		if (variables.size() > TruthTable::max_variables) {
+			throw std::out_of_range("Formula contains too many variables to transform.");
+		}
+
+		auto affine = affine_form(formula);
+		if (not affine.has_value()) {
+			coefficients = TruthTable(formula).get_rows();
+			mobius_transform(coefficients, variables.size());
+			return;
+		}
+
+		/* affine formulas only have the constant and single variable monomials */
+		coefficients.assign(TruthTable::num_words(variables.size()), 0);
+		if (affine->constant) set_monomial(coefficients, 0);
+		for (auto index : affine->variables) {
+			auto position = std::lower_bound(variables.begin(), variables.end(), VariableTable::name(index)) - variables.begin();
+			set_monomial(coefficients, std::uint64_t(1) << position);
+		}
+	}
+
+	ANF ANF::parity(std::vector<std::string> variables) {
+		if (variables.size() > TruthTable::max_variables) {
+			throw std::out_of_range("Too many variables to transform.");
+		}
+
+		std::vector<std::uint64_t> coefficients(TruthTable::num_words(variables.size()), 0);
+		for (std::size_t position = 0; position < variables.size(); position++) {
+			set_monomial(coefficients, std::uint64_t(1) << position);
+		}
+
+		return { std::move(variables), std::move(coefficients) };
+	}
+
+	void ANF::mobius_transform(std::vector<std::uint64_t>& table, std::size_t num_variables) {
+		/* butterflies within a word - add row r to row r + 2^i for every r without bit i */
+		for (std::size_t i = 0; i < std::min<std::size_t>(num_variables, 6); i++) {
+			for (auto & word : table) {
+				word ^= (word & ~TruthTable::columns[i]) << (1 << i);
+			}
+		}
+
+		/* butterflies between whole words */
+		for (std::size_t i = 6; i < num_variables; i++) {
+			std::size_t stride = std::size_t(1) << (i - 6);
+			for (std::size_t word = 0; word < table.size(); word++) {
+				if (not (word & stride)) table[word | stride] ^= table[word];
+			}
+		}
+	}
+
+	std::optional<AffineForm> ANF::affine_form(const Formula& formula) {
+		std::unordered_map<const Formula*, std::optional<AffineForm>> memo;
+
+		auto add = [](const AffineForm& a, const AffineForm& b) {
+			AffineForm sum { {}, a.constant != b.constant };
+			std::set_symmetric_difference(
+				a.variables.begin(), a.variables.end(),
+				b.variables.begin(), b.variables.end(),
+				std::back_inserter(sum.variables)
+			);
+			return sum;
+		};
+
+		std::function<bool(const Formula&, const Formula&)> same = [&](const Formula& a, const Formula& b) {
+			if (&a == &b) return true;
+			if (a.atom.has_value() || b.atom.has_value()) {
+				return a.atom.has_value() && b.atom.has_value()
+				    && a.atom->type == b.atom->type && a.atom->name == b.atom->name;
+			}
+
+			if (a.connective != b.connective) return false;
+			if (*a.connective != Connective::negation && not same(*a.lsf, *b.lsf)) return false;
+			return same(*a.rsf, *b.rsf);
+		};
+
+		/* matches A ∧ ¬B, giving A and B */
+		auto positive_and_negated = [](const Formula& node) -> std::optional<std::pair<const Formula*, const Formula*>> {
+			if (node.connective != Connective::conjunction || node.rsf->connective != Connective::negation) return std::nullopt;
+			return std::pair { node.lsf.get(), node.rsf->rsf.get() };
+		};
+
+		std::function<std::optional<AffineForm>(const Formula&)> affine = [&](const Formula& node) -> std::optional<AffineForm> {
+			if (node.atom.has_value()) {
+				switch (node.atom->type) {
+					case AtomType::variable:
+						return AffineForm { { node.atom->index }, false };
+					case AtomType::tautology:
+						return AffineForm { {}, true };
+					case AtomType::contradiction:
+						return AffineForm { {}, false };
+				}
+			}
+
+			if (auto it = memo.find(&node); it != memo.end()) return it->second;
+
+			std::optional<AffineForm> result;
+			switch (*node.connective) {
+				case Connective::negation:
+					if ((result = affine(*node.rsf))) result->constant = not result->constant;
+					break;
+				case Connective::biimplication:
+					/* a ↔ b = 1 ⊕ a ⊕ b */
+					if (auto lhs = affine(*node.lsf)) {
+						if (auto rhs = affine(*node.rsf)) {
+							result = add(*lhs, *rhs);
+							result->constant = not result->constant;
+						}
+					}
+					break;
+				case Connective::disjunction: {
+					/* (A ∧ ¬B) ∨ (B ∧ ¬A) is how A ^ B is built */
+					auto lhs = positive_and_negated(*node.lsf);
+					auto rhs = positive_and_negated(*node.rsf);
+					if (not lhs || not rhs || not same(*lhs->first, *rhs->second) || not same(*lhs->second, *rhs->first)) break;
+
+					if (auto a = affine(*lhs->first)) {
+						if (auto b = affine(*lhs->second)) result = add(*a, *b);
+					}
+					break;
+				}
+				case Connective::conjunction:
+				case Connective::implication:
+					break;
+			}
+
+			memo.emplace(&node, result);
+			return result;
+		};
+
+		return affine(formula);
+	}
+
+	void ANF::check_compatible(const ANF& other) const {
+		if (variables != other.variables) {
+			throw std::invalid_argument("Polynomials are over different variables.");
+		}
+	}
+
+	const std::vector<std::string>& ANF::get_variables() const {
+		return variables;
+	}
+
+	bool ANF::coefficient(std::uint64_t monomial) const {
+		if (monomial >= (std::uint64_t(1) << variables.size())) return false;
+
+		return (coefficients[monomial / 64] >> (monomial % 64)) & 1;
+	}
+
+	std::size_t ANF::num_monomials() const {
+		std::size_t count = 0;
+		for (auto word : coefficients) {
+			count += std::popcount(word);
+		}
+
+		return count;
+	}
+
+	/* the degree of the zero polynomial is taken to be 0 */
+	std::size_t ANF::degree() const {
+		/* bit b is set in weights[k] if b has k bits set */
+		static const auto weights = [] {
+			std::array<std::uint64_t, 7> masks {};
+			for (std::uint64_t bit = 0; bit < 64; bit++) {
+				masks[std::popcount(bit)] |= std::uint64_t(1) << bit;
+			}
+			return masks;
+		}();
+
+		std::size_t degree = 0;
+		for (std::size_t word = 0; word < coefficients.size(); word++) {
+			if (coefficients[word] == 0) continue;
+
+			/* monomial 64 * word + bit has the weight of word plus the weight of bit */
+			std::size_t highest = 6;
+			while ((coefficients[word] & weights[highest]) == 0) highest--;
+			degree = std::max<std::size_t>(degree, std::popcount(word) + highest);
+		}
+
+		return degree;
+	}
+
+	bool ANF::is_zero() const {
+		return std::all_of(coefficients.begin(), coefficients.end(), [](std::uint64_t word) { return word == 0; });
+	}
+
+	bool ANF::is_affine() const {
+		return degree() <= 1;
+	}
+
+	bool ANF::is_linear() const {
+		return is_affine() && not coefficient(0);
+	}
+
+	ANF ANF::operator^(const ANF& other) const {
+		check_compatible(other);
+
+		auto sum = coefficients;
+		for (std::size_t word = 0; word < sum.size(); word++) {
+			sum[word] ^= other.coefficients[word];
+		}
+
+		return { variables, std::move(sum) };
+	}
+
+	ANF ANF::operator*(const ANF& other) const {
+		check_compatible(other);
+
+		/* multiplying polynomials is conjunction of their truth tables */
+		auto lhs = coefficients, rhs = other.coefficients;
+		mobius_transform(lhs, variables.size());
+		mobius_transform(rhs, variables.size());
+
+		for (std::size_t word = 0; word < lhs.size(); word++) {
+			lhs[word] &= rhs[word];
+		}
+		mobius_transform(lhs, variables.size());
+
+		return { variables, std::move(lhs) };
+	}
+
+	bool ANF::operator==(const ANF& other) const {
+		return variables == other.variables && coefficients == other.coefficients;
+	}
+
+	std::ostream& operator<<(std::ostream& os, const ANF& anf) {
+		if (anf.is_zero()) return os << "0";
+
+		bool first_term = true;
+		for (std::uint64_t monomial = 0; monomial < (std::uint64_t(1) << anf.variables.size()); monomial++) {
+			if (not anf.coefficient(monomial)) continue;
+
+			if (!first_term) {
+				os << " ⊕ ";
+			} else {
+				first_term = false;
+			}
+
+			if (monomial == 0) {
+				os << "1";
+				continue;
+			}
+
+			bool first_factor = true;
+			for (std::size_t position = 0; position < anf.variables.size(); position++) {
+				if (not ((monomial >> position) & 1)) continue;
+
+				if (!first_factor) os << "∧";
+				first_factor = false;
+				os << anf.variables[position];
+			}
+		}
+
+		return os;
+	}
+}
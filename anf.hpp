@@ -0,0 +1,70 @@
+#pragma once
+
+#include "formula.hpp"
+#include "truth_table.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace logic {
+	/* c ⊕ x1 ⊕ ... ⊕ xk - an affine function of some variables */
+	struct AffineForm {
+		/* VariableTable indices of the variables with coefficient 1, sorted */
+		std::vector<std::size_t> variables;
+		bool constant;
+	};
+
+	/*
+	 * algebraic normal form - a formula as an XOR of conjunctions of variables (Zhegalkin polynomial)
+	 *
+	 * The coefficients are computed from a bit-packed truth table using an in-place
+	 * fast Möbius transform, unless the formula is recognisably affine from its structure.
+	 */
+	class ANF {
+		/* variable i of the polynomial is bit i of a monomial */
+		std::vector<std::string> variables;
+
+		/* bit m is set if the monomial m - the conjunction of the variables in m - is present */
+		std::vector<std::uint64_t> coefficients;
+
+		ANF(std::vector<std::string>, std::vector<std::uint64_t>);
+
+		/* the transform is its own inverse, it converts between truth tables and coefficients */
+		static void mobius_transform(std::vector<std::uint64_t>&, std::size_t num_variables);
+
+		void check_compatible(const ANF&) const;
+
+	public:
+		ANF(const Formula&);
+		ANF(const TruthTable&);
+
+		/* x1 ⊕ ... ⊕ xn */
+		static ANF parity(std::vector<std::string> variables);
+
+		/* recognise formulas built from variables, constants, ¬, ↔ and ^ without evaluating them */
+		static std::optional<AffineForm> affine_form(const Formula&);
+
+		const std::vector<std::string>& get_variables() const;
+
+		/* is the monomial - a set of variables as a bitmask - present */
+		bool coefficient(std::uint64_t monomial) const;
+		std::size_t num_monomials() const;
+
+		/* the size of the largest monomial */
+		std::size_t degree() const;
+
+		bool is_zero() const;
+		bool is_affine() const;
+		bool is_linear() const;
+
+		/* addition and multiplication over GF(2), both sides must have the same variables */
+		ANF operator^(const ANF&) const;
+		ANF operator*(const ANF&) const;
+
+		bool operator==(const ANF&) const;
+
+		friend std::ostream& operator<<(std::ostream&, const ANF&);
+	};
+}
@@ -0,0 +1,264 @@
+#include "cnf.hpp"
+#include <iostream>
+#include <utility>
+
+namespace logic {
+	/* state which lives for the duration of a single call to add */
+	struct CNF::EncodingState {
+		/* literals already given to a subformula, so shared subformulas are only encoded once */
+		std::unordered_map<const Formula*, Literal> memo;
+
+		/* a literal constrained to be true, created the first time ⊤ or ⊥ is encoded */
+		std::optional<Literal> truth;
+	};
+
+	CNF::CNF(const Formula& formula) {
+		add(formula);
+	}
+
+	void CNF::add(const Formula& formula) {
+		EncodingState state;
+		assert_formula(formula, true, state);
+
+		/* variables folded away with a constant still need an index */
+		for (const auto & name : formula.get_variables()) {
+			variable(name);
+		}
+	}
+
+	void CNF::add_clause(Clause clause) {
+		clauses.push_back(std::move(clause));
+	}
+
+	std::uint32_t CNF::variable(const std::string& name) {
+		auto [it, inserted] = indices.try_emplace(name, names.size());
+		if (inserted) names.push_back(name);
+
+		return it->second;
+	}
+
+	std::uint32_t CNF::new_variable() {
+		names.emplace_back();
+		return names.size() - 1;
+	}
+
+	std::optional<std::uint32_t> CNF::find(const std::string& name) const {
+		auto it = indices.find(name);
+		if (it == indices.end()) return std::nullopt;
+
+		return it->second;
+	}
+
+	const std::string& CNF::name(std::uint32_t variable) const {
+		return names.at(variable);
+	}
+
+	bool CNF::is_auxiliary(std::uint32_t variable) const {
+		return names.at(variable).empty();
+	}
+
+	std::size_t CNF::num_variables() const {
+		return names.size();
+	}
+
+	const std::vector<Clause>& CNF::get_clauses() const {
+		return clauses;
+	}
+
+	std::vector<Clause> CNF::release_clauses() {
+		return std::exchange(clauses, {});
+	}
+
+	/* add clauses forcing the formula to take the given polarity */
+	void CNF::assert_formula(const Formula& formula, bool polarity, EncodingState& state) {
+		if (formula.atom.has_value() && formula.atom->type != AtomType::variable) {
+			/* asserting ⊤ is a no-op, asserting ⊥ gives the empty clause */
+			bool value = formula.atom->type == AtomType::tautology;
+			if (value != polarity) add_clause({});
+			return;
+		}
+
+		if (not formula.atom.has_value()) {
+			switch (*formula.connective) {
+				case Connective::negation:
+					assert_formula(*formula.rsf, not polarity, state);
+					return;
+				case Connective::conjunction:
+					if (not polarity) break;
+					assert_formula(*formula.lsf, true, state);
+					assert_formula(*formula.rsf, true, state);
+					return;
+				case Connective::disjunction:
+					if (polarity) break;
+					assert_formula(*formula.lsf, false, state);
+					assert_formula(*formula.rsf, false, state);
+					return;
+				case Connective::implication:
+					if (polarity) break;
+					assert_formula(*formula.lsf, true, state);
+					assert_formula(*formula.rsf, false, state);
+					return;
+				case Connective::biimplication: {
+					auto lhs = encode(*formula.lsf, state);
+					auto rhs = encode(*formula.rsf, state);
+					if (polarity) {
+						add_clause({ ~lhs, rhs });
+						add_clause({ lhs, ~rhs });
+					} else {
+						add_clause({ lhs, rhs });
+						add_clause({ ~lhs, ~rhs });
+					}
+					return;
+				}
+			}
+		}
+
+		/* the formula is a single clause */
+		Clause clause;
+		if (not append_disjuncts(formula, polarity, clause, state)) {
+			add_clause(std::move(clause));
+		}
+	}
+
+	/*
+	 * flatten the disjunction formed by the formula with the given polarity into clause,
+	 * returns true if one of the disjuncts is ⊤ - in which case the clause is useless
+	 */
+	bool CNF::append_disjuncts(const Formula& formula, bool polarity, Clause& clause, EncodingState& state) {
+		if (formula.atom.has_value()) {
+			switch (formula.atom->type) {
+				case AtomType::variable:
+					clause.emplace_back(variable(formula.atom->name), not polarity);
+					return false;
+				case AtomType::tautology:
+					return polarity;
+				case AtomType::contradiction:
+					return not polarity;
+			}
+		}
+
+		switch (*formula.connective) {
+			case Connective::negation:
+				return append_disjuncts(*formula.rsf, not polarity, clause, state);
+			case Connective::conjunction:
+				if (polarity) break;
+				return append_disjuncts(*formula.lsf, false, clause, state)
+				    || append_disjuncts(*formula.rsf, false, clause, state);
+			case Connective::disjunction:
+				if (not polarity) break;
+				return append_disjuncts(*formula.lsf, true, clause, state)
+				    || append_disjuncts(*formula.rsf, true, clause, state);
+			case Connective::implication:
+				if (not polarity) break;
+				return append_disjuncts(*formula.lsf, false, clause, state)
+				    || append_disjuncts(*formula.rsf, true, clause, state);
+			case Connective::biimplication:
+				break;
+		}
+
+		/* anything else gets its own variable */
+		auto literal = encode(formula, state);
+		clause.push_back(polarity ? literal : ~literal);
+		return false;
+	}
+
+	/* produce a literal which is equivalent to the formula */
+	Literal CNF::encode(const Formula& formula, EncodingState& state) {
+		if (formula.atom.has_value()) {
+			if (formula.atom->type == AtomType::variable) {
+				return variable(formula.atom->name);
+			}
+
+			return constant(formula.atom->type == AtomType::tautology, state);
+		}
+
+		if (*formula.connective == Connective::negation) {
+			return ~encode(*formula.rsf, state);
+		}
+
+		if (auto it = state.memo.find(&formula); it != state.memo.end()) {
+			return it->second;
+		}
+
+		Literal literal;
+		switch (*formula.connective) {
+			case Connective::conjunction:
+				/* a ∧ b is encoded as ¬(¬a ∨ ¬b) */
+				literal = ~encode_disjunction(formula, false, state);
+				break;
+			case Connective::disjunction:
+			case Connective::implication:
+				literal = encode_disjunction(formula, true, state);
+				break;
+			case Connective::biimplication: {
+				auto lhs = encode(*formula.lsf, state);
+				auto rhs = encode(*formula.rsf, state);
+				literal = new_variable();
+				add_clause({ ~literal, ~lhs, rhs });
+				add_clause({ ~literal, lhs, ~rhs });
+				add_clause({ literal, lhs, rhs });
+				add_clause({ literal, ~lhs, ~rhs });
+				break;
+			}
+			case Connective::negation:
+				break;
+		}
+
+		state.memo.emplace(&formula, literal);
+		return literal;
+	}
+
+	/* a literal with a fixed value */
+	Literal CNF::constant(bool value, EncodingState& state) {
+		if (not state.truth.has_value()) {
+			state.truth = new_variable();
+			add_clause({ *state.truth });
+		}
+
+		return value ? *state.truth : ~*state.truth;
+	}
+
+	/* Tseitin encoding of a flattened disjunction */
+	Literal CNF::encode_disjunction(const Formula& formula, bool polarity, EncodingState& state) {
+		Clause disjuncts;
+		bool trivial = append_disjuncts(formula, polarity, disjuncts, state);
+
+		if (trivial || disjuncts.empty()) return constant(trivial, state);
+
+		if (disjuncts.size() == 1) return disjuncts.front();
+
+		Literal literal = new_variable();
+
+		/* literal -> (d1 ∨ ... ∨ dn) */
+		Clause definition = { ~literal };
+		definition.insert(definition.end(), disjuncts.begin(), disjuncts.end());
+		add_clause(std::move(definition));
+
+		/* di -> literal */
+		for (const auto & disjunct : disjuncts) {
+			add_clause({ literal, ~disjunct });
+		}
+
+		return literal;
+	}
+
+	/* DIMACS output */
+	std::ostream& operator<<(std::ostream& os, const CNF& cnf) {
+		for (std::uint32_t variable = 0; variable < cnf.names.size(); variable++) {
+			if (not cnf.names[variable].empty()) {
+				os << "c " << variable + 1 << ' ' << cnf.names[variable] << '\n';
+			}
+		}
+
+		os << "p cnf " << cnf.names.size() << ' ' << cnf.clauses.size() << '\n';
+		for (const auto & clause : cnf.clauses) {
+			for (const auto & literal : clause) {
+				if (literal.negated()) os << '-';
+				os << literal.variable() + 1 << ' ';
+			}
+			os << "0\n";
+		}
+
+		return os;
+	}
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "formula.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace logic {
+	/* a literal in clause form
+	 * the variable index is stored in the upper bits and the sign in the lowest bit,
+	 * so the code of a literal can be used directly as an array index */
+	struct Literal {
+		std::uint32_t code;
+
+		Literal() = default;
+		constexpr Literal(std::uint32_t variable, bool negated = false) : code(variable << 1 | negated) { }
+
+		static constexpr Literal from_code(std::uint32_t code) {
+			Literal literal;
+			literal.code = code;
+			return literal;
+		}
+
+		constexpr std::uint32_t variable() const { return code >> 1; }
+		constexpr bool negated() const { return code & 1; }
+
+		constexpr Literal operator~() const { return from_code(code ^ 1); }
+		constexpr bool operator==(const Literal&) const = default;
+	};
+
+	/* a clause is a disjunction of literals */
+	using Clause = std::vector<Literal>;
+
+	/*
+	 * a formula in conjunctive normal form
+	 *
+	 * Formulas are added by asserting them: top level conjunctions are split up,
+	 * subformulas that are already clauses are copied over directly, and everything
+	 * else is given an auxiliary variable using the Tseitin transformation.
+	 *
+	 * Named variables keep a stable index across calls to add,
+	 * auxiliary variables have an empty name. Every variable of an added formula
+	 * is given an index, even one which only occurs next to ⊤ or ⊥ and so never
+	 * reaches a clause, so models over the variables are total.
+	 */
+	class CNF {
+		std::vector<Clause> clauses;
+
+		/* index -> name, empty for auxiliary variables */
+		std::vector<std::string> names;
+
+		/* name -> index */
+		std::unordered_map<std::string, std::uint32_t> indices;
+
+		/* state which lives for the duration of a single call to add */
+		struct EncodingState;
+
+		void assert_formula(const Formula&, bool polarity, EncodingState&);
+		Literal encode(const Formula&, EncodingState&);
+		Literal encode_disjunction(const Formula&, bool polarity, EncodingState&);
+		bool append_disjuncts(const Formula&, bool polarity, Clause&, EncodingState&);
+		Literal constant(bool, EncodingState&);
+
+	public:
+		/* default constructor - the empty conjunction */
+		CNF() = default;
+
+		CNF(const Formula&);
+
+		/* conjoin a formula with the clause set */
+		void add(const Formula&);
+		void add_clause(Clause);
+
+		/* index of a named variable, creating it if it doesn't exist yet */
+		std::uint32_t variable(const std::string&);
+		/* create a new auxiliary variable */
+		std::uint32_t new_variable();
+
+		std::optional<std::uint32_t> find(const std::string&) const;
+		const std::string& name(std::uint32_t) const;
+		bool is_auxiliary(std::uint32_t) const;
+
+		std::size_t num_variables() const;
+		const std::vector<Clause>& get_clauses() const;
+
+		/* move the clauses out, leaving the variable table intact */
+		std::vector<Clause> release_clauses();
+
+		/* DIMACS output */
+		friend std::ostream& operator<<(std::ostream&, const CNF&);
+	};
+}
@@ -1,4 +1,4 @@
 CXX = clang++
-CXXFLAGS = -std=c++20 -pedantic -ggdb
+CXXFLAGS = -std=c++20 -pedantic -ggdb -pthread
 AR = ar
 RANLIB = ranlib
@@ -1,7 +1,12 @@
 #include "formula.hpp"
+#include "anf.hpp"
 #include <iostream>
 #include <algorithm>
+#include <bit>
 #include <bitset>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
 #include <sstream>
 
 #include <codecvt>
@@ -9,34 +14,162 @@
 #include <locale>
 
 namespace logic {
+	namespace {
+		/* storage for VariableTable - a deque so references to names stay valid as it grows */
+		struct VariableStorage {
+			std::shared_mutex mutex;
+			std::deque<std::string> names;
+			std::unordered_map<std::string, std::size_t> indices;
+		};
+
+		VariableStorage& variable_storage() {
+			static VariableStorage storage;
+			return storage;
+		}
+
+		/* the word and bit holding a variable's valuation */
+		constexpr std::size_t word_of(std::size_t index) { return index / 64; }
+		constexpr std::uint64_t bit_of(std::size_t index) { return std::uint64_t(1) << (index % 64); }
+
+		/* word number word of a range of words starting at first, zero outside of it */
+		std::uint64_t word_at(const std::vector<std::uint64_t>& words, std::size_t first, std::size_t word) {
+			return word >= first && word - first < words.size() ? words[word - first] : 0;
+		}
+	}
+
+	std::size_t VariableTable::intern(const std::string& name) {
+		auto& storage = variable_storage();
+		{
+			std::shared_lock lock(storage.mutex);
+			auto it = storage.indices.find(name);
+			if (it != storage.indices.end()) return it->second;
+		}
+
+		std::unique_lock lock(storage.mutex);
+		auto [it, inserted] = storage.indices.try_emplace(name, storage.names.size());
+		if (inserted) storage.names.push_back(name);
+
+		return it->second;
+	}
+
+	std::optional<std::size_t> VariableTable::find(const std::string& name) {
+		auto& storage = variable_storage();
+		std::shared_lock lock(storage.mutex);
+
+		auto it = storage.indices.find(name);
+		if (it == storage.indices.end()) return std::nullopt;
+
+		return it->second;
+	}
+
+	const std::string& VariableTable::name(std::size_t index) {
+		auto& storage = variable_storage();
+		std::shared_lock lock(storage.mutex);
+
+		return storage.names.at(index);
+	}
+
+	std::size_t VariableTable::size() {
+		auto& storage = variable_storage();
+		std::shared_lock lock(storage.mutex);
+
+		return storage.names.size();
+	}
+
+	Interpretation::reference::operator bool() const {
+		return interpretation.at(index);
+	}
+
+	Interpretation::reference& Interpretation::reference::operator=(bool value) {
+		interpretation.set(index, value);
+		return *this;
+	}
+
+	Interpretation::reference& Interpretation::reference::operator=(const reference& other) {
+		return *this = bool(other);
+	}
+
+	Interpretation::const_iterator::const_iterator(const Interpretation* _interpretation, std::size_t _index)
+		: interpretation(_interpretation), index(_index)
+	{
+		/* move onto the first assigned variable */
+		auto end = 64 * (interpretation->first_word + interpretation->assigned.size());
+		if (index < end && not interpretation->contains(index)) ++*this;
+	}
+
+	const Interpretation::const_iterator::value_type& Interpretation::const_iterator::operator*() const {
+		current.emplace(VariableTable::name(index), interpretation->at(index));
+		return *current;
+	}
+
+	Interpretation::const_iterator& Interpretation::const_iterator::operator++() {
+		const auto & assigned = interpretation->assigned;
+		auto first = interpretation->first_word;
+
+		/* skip to the next set bit of assigned */
+		index++;
+		while (word_of(index) - first < assigned.size()) {
+			auto remaining = assigned[word_of(index) - first] >> (index % 64);
+			if (remaining != 0) {
+				index += std::countr_zero(remaining);
+				return *this;
+			}
+			index = 64 * (word_of(index) + 1);
+		}
+
+		index = 64 * (first + assigned.size());
+		return *this;
+	}
+
+	Interpretation::const_iterator Interpretation::const_iterator::operator++(int) {
+		auto copy = *this;
+		++*this;
+		return copy;
+	}
+
+	bool Interpretation::const_iterator::operator==(const const_iterator& other) const {
+		return interpretation == other.interpretation && index == other.index;
+	}
+
 	Interpretation::Interpretation(std::vector<std::pair<std::string, bool>> valuation) {
 		/* initialize the interpretation from a list of pairs - name to valuation */
-		std::copy(
-			valuation.begin(), valuation.end(),
-			std::inserter(mapping, mapping.end())
-		);
+		for (const auto & [name, value] : valuation) {
+			set(VariableTable::intern(name), value);
+		}
 	}
 
-	bool& Interpretation::operator[](const std::string& name) {
-		return mapping[name];
+	Interpretation::reference Interpretation::operator[](const std::string& name) {
+		return (*this)[VariableTable::intern(name)];
 	}
 
-	bool& Interpretation::operator[](const Atom& atom) {
+	Interpretation::reference Interpretation::operator[](const Atom& atom) {
 		if (atom.type != AtomType::variable)
 				throw std::runtime_error("Mutable references can only be taken for propositional variables.");
 
-		return mapping[atom.name];
+		return (*this)[atom.index];
+	}
+
+	Interpretation::reference Interpretation::operator[](std::size_t index) {
+		/* like std::map, indexing assigns a default valuation */
+		if (not contains(index)) set(index, false);
+
+		return { *this, index };
 	}
 
 	/* .at overloads */
 	bool Interpretation::at(const std::string& name) const {
-		return mapping.at(name);
+		auto index = VariableTable::find(name);
+		if (not index.has_value()) {
+			throw std::out_of_range("Variable has no valuation in this interpretation.");
+		}
+
+		return at(*index);
 	}
 
 	bool Interpretation::at(const Atom& atom) const {
 		switch (atom.type) {
 			case AtomType::variable:
-				return mapping.at(atom.name);
+				return at(atom.index);
 			case AtomType::tautology:
 				return true;
 			case AtomType::contradiction:
@@ -44,10 +177,71 @@ namespace logic {
 		}
 	}
 
+	bool Interpretation::at(std::size_t index) const {
+		if (not contains(index)) {
+			throw std::out_of_range("Variable has no valuation in this interpretation.");
+		}
+
+		return word_at(values, first_word, word_of(index)) & bit_of(index);
+	}
+
+	void Interpretation::set(std::size_t index, bool value) {
+		auto word = word_of(index);
+
+		/* widen the stored range to cover the word, starting afresh if nothing is assigned */
+		if (word < first_word || word - first_word >= assigned.size()) {
+			if (empty()) {
+				values.clear();
+				assigned.clear();
+				first_word = word;
+			} else if (word < first_word) {
+				values.insert(values.begin(), first_word - word, 0);
+				assigned.insert(assigned.begin(), first_word - word, 0);
+				first_word = word;
+			}
+
+			if (word - first_word >= assigned.size()) {
+				values.resize(word - first_word + 1);
+				assigned.resize(word - first_word + 1);
+			}
+		}
+
+		assigned[word - first_word] |= bit_of(index);
+		if (value) {
+			values[word - first_word] |= bit_of(index);
+		} else {
+			values[word - first_word] &= ~bit_of(index);
+		}
+	}
+
+	void Interpretation::flip(std::size_t index) {
+		set(index, not at(index));
+	}
+
+	void Interpretation::flip(const std::string& name) {
+		flip(VariableTable::intern(name));
+	}
+
+	void Interpretation::erase(std::size_t index) {
+		if (not contains(index)) return;
+
+		assigned[word_of(index) - first_word] &= ~bit_of(index);
+		values[word_of(index) - first_word] &= ~bit_of(index);
+	}
+
+	bool Interpretation::contains(std::size_t index) const {
+		return word_at(assigned, first_word, word_of(index)) & bit_of(index);
+	}
+
+	bool Interpretation::contains(const std::string& name) const {
+		auto index = VariableTable::find(name);
+		return index.has_value() && contains(*index);
+	}
+
 	std::ostream& operator<<(std::ostream& os, const Interpretation& interp) {
 		os << '[';
 		bool first_elem = true;
-		for (const auto& [name, value]: interp.mapping) {
+		for (const auto& [name, value]: interp) {
 			if (!first_elem) {
 				os << ", ";
 			} else {
@@ -62,13 +256,61 @@ namespace logic {
 
 	std::size_t Interpretation::count_satisfied() const {
 		std::size_t count = 0;
-		for (const auto & [name, value]: mapping) {
-			if (value) count++;
+		for (auto word : values) {
+			count += std::popcount(word);
+		}
+
+		return count;
+	}
+
+	std::size_t Interpretation::size() const {
+		std::size_t count = 0;
+		for (auto word : assigned) {
+			count += std::popcount(word);
 		}
 
 		return count;
 	}
 
+	bool Interpretation::empty() const {
+		return std::all_of(assigned.begin(), assigned.end(), [](std::uint64_t word) { return word == 0; });
+	}
+
+	Interpretation::const_iterator Interpretation::begin() const {
+		return { this, 64 * first_word };
+	}
+
+	Interpretation::const_iterator Interpretation::end() const {
+		return { this, 64 * (first_word + assigned.size()) };
+	}
+
+	bool Interpretation::operator==(const Interpretation& other) const {
+		/* the ranges can differ, words outside of a range are zero */
+		auto first = std::min(first_word, other.first_word);
+		auto last = std::max(first_word + assigned.size(), other.first_word + other.assigned.size());
+
+		for (auto word = first; word < last; word++) {
+			if (word_at(assigned, first_word, word) != word_at(other.assigned, other.first_word, word)) return false;
+			if (word_at(values, first_word, word) != word_at(other.values, other.first_word, word)) return false;
+		}
+
+		return true;
+	}
+
+	std::size_t Interpretation::hash() const {
+		/* zero words are skipped so equal interpretations hash the same whatever their range */
+		std::size_t seed = 0;
+		for (std::size_t i = 0; i < assigned.size(); i++) {
+			if (assigned[i] == 0) continue;
+
+			for (auto word : { std::uint64_t(first_word + i), assigned[i], values[i] }) {
+				seed ^= std::hash<std::uint64_t>{}(word) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+			}
+		}
+
+		return seed;
+	}
+
 	/* normal left side connective right side constructor */
 	Formula::Formula(const Formula& _lsf, Connective _connective, const Formula& _rsf)
 		: lsf(new Formula(_lsf)), connective(_connective), rsf(new Formula(_rsf))
@@ -89,21 +331,52 @@ namespace logic {
 		}*/
 	}
 
+	/* constructor from existing subformulas, lsf is nullptr for negation */
+	Formula::Formula(std::shared_ptr<const Formula> _lsf, Connective _connective, std::shared_ptr<const Formula> _rsf)
+		: lsf(std::move(_lsf)), connective(_connective), rsf(std::move(_rsf))
+	{
+		if (not lsf) {
+			variables = rsf->variables;
+			return;
+		}
+
+		std::set_union(
+			lsf->variables.begin(), lsf->variables.end(),
+			rsf->variables.begin(), rsf->variables.end(),
+			std::back_inserter(this->variables)
+		);
+	}
+
 	/* constructor for negation */
 	Formula::Formula(Connective _connective, const Formula& _rsf)
 		: connective(_connective), rsf(new Formula(_rsf)), variables(_rsf.variables) { }
 
 	/* atom constructor */
-	Formula::Formula(Atom _atom) : atom(_atom), variables({ _atom.name }) { }
+	Formula::Formula(Atom _atom) : atom(_atom) {
+		/* ⊤ and ⊥ don't introduce a variable */
+		if (_atom.type == AtomType::variable) variables.push_back(_atom.name);
+	}
 
 	/* atomic variable constructor */
-	Formula::Formula(const char * name) : atom({ name, AtomType::variable }), variables({ name }) { }
+	Formula::Formula(const char * name) : atom(Atom(name, AtomType::variable)), variables({ name }) { }
 
 	/* propositional variable constructors */
 	Formula Formula::PropVar(const char * name) { return Formula(Atom(name, AtomType::variable)); }
 	Formula Formula::Tautology() { return Formula(Atom("", AtomType::tautology)); }
 	Formula Formula::Contradiction() { return Formula(Atom("", AtomType::contradiction)); }
 
+	Formula Formula::Cube(const Interpretation& I) {
+		std::optional<Formula> cube;
+		for (const auto & [name, value] : I) {
+			Formula literal(Atom(name, AtomType::variable));
+			if (not value) literal = not literal;
+
+			cube = cube.has_value() ? (*cube and literal) : literal;
+		}
+
+		return cube.value_or(Tautology());
+	}
+
 	/* Parse a formula from a string expression */
 	/* static Formula Parse(std::string& expression);*/
 
@@ -131,35 +404,65 @@ namespace logic {
 
 	/* other functions returning a new formula */
 	Formula Formula::replace(const std::string& varname, const Formula& replacement) const {
-		std::cout << "HECC: " << *this << std::endl;
-		/* replace an atomic variable with a formula */
-
-		/* we are an atom */
-		if (this->atom.has_value()) {
-			/* replace this atom */
-			if (atom->name == varname) {
-				return replacement;
-			}
+		return substitute({ { varname, replacement } });
+	}
+
+	Formula Formula::substitute(const std::unordered_map<std::string, Formula>& substitution) const {
+		if (not mentions_any(substitution)) return *this;
+
+		/* the root isn't owned by a shared_ptr, so it is handled here */
+		if (atom.has_value()) return substitution.at(atom->name);
+
+		SubstitutionMemo memo;
+		auto left = lsf ? substitute(lsf, substitution, memo) : nullptr;
+		auto right = substitute(rsf, substitution, memo);
+
+		return { left, *connective, right };
+	}
+
+	Formula& Formula::replace_in_place(const std::string& varname, const Formula& replacement) {
+		return *this = replace(varname, replacement);
+	}
+
+	Formula& Formula::substitute_in_place(const std::unordered_map<std::string, Formula>& substitution) {
+		return *this = substitute(substitution);
+	}
+
+	std::shared_ptr<const Formula> Formula::substitute(
+		const std::shared_ptr<const Formula>& formula,
+		const std::unordered_map<std::string, Formula>& substitution,
+		SubstitutionMemo& memo
+	) {
+		if (not formula->mentions_any(substitution)) return formula;
+
+		/* subformulas shared between several parents are only rewritten once */
+		if (auto it = memo.find(formula.get()); it != memo.end()) return it->second;
+
+		std::shared_ptr<const Formula> result;
+		if (formula->atom.has_value()) {
+			result = std::make_shared<const Formula>(substitution.at(formula->atom->name));
 		} else {
-			/* we are a formula */
-
-			/* if we are anything but a negation then do the lsf */
-			if (this->connective == Connective::negation) {
-				return {
-					Connective::negation,
-					this->rsf->replace(varname, replacement)
-				};
-			} else {
-				return { 
-					this->lsf->replace(varname, replacement),
-					Connective::negation,
-					this->rsf->replace(varname, replacement)
-				};
-			}
+			auto left = formula->lsf ? substitute(formula->lsf, substitution, memo) : nullptr;
+			auto right = substitute(formula->rsf, substitution, memo);
+			result = std::shared_ptr<const Formula>(new Formula(left, *formula->connective, right));
 		}
 
-		/* return a copy of the current node */
-		return *this;
+		memo.emplace(formula.get(), result);
+		return result;
+	}
+
+	/* does the formula contain any of the variables being substituted */
+	bool Formula::mentions_any(const std::unordered_map<std::string, Formula>& substitution) const {
+		/* search whichever side is smaller */
+		if (substitution.size() < variables.size()) {
+			return std::any_of(substitution.begin(), substitution.end(), [&](const auto& entry) {
+				return std::binary_search(variables.begin(), variables.end(), entry.first);
+			});
+		}
+
+		return std::any_of(variables.begin(), variables.end(), [&](const std::string& variable) {
+			return substitution.contains(variable);
+		});
 	}
 
 	/* stream output operator */
@@ -259,19 +562,75 @@ namespace logic {
 		}
 	}
 
+	/* VariableTable indices of the formula's variables, in the same order */
+	std::vector<std::size_t> Formula::variable_indices() const {
+		std::vector<std::size_t> indices;
+		std::transform(variables.begin(), variables.end(), std::back_inserter(indices), VariableTable::intern);
+
+		return indices;
+	}
+
+	std::optional<bool> Formula::eval_partial(const Interpretation& I) const {
+		if (atom.has_value()) {
+			if (atom->type == AtomType::variable && not I.contains(atom->index)) return std::nullopt;
+			return I.at(*atom);
+		}
+
+		/* a known side can decide the connective on its own */
+		auto rhs = rsf->eval_partial(I);
+		if (*connective == Connective::negation) {
+			if (not rhs.has_value()) return std::nullopt;
+			return not *rhs;
+		}
+
+		auto lhs = lsf->eval_partial(I);
+		switch (*connective) {
+			case Connective::conjunction:
+				if (lhs == false || rhs == false) return false;
+				break;
+			case Connective::disjunction:
+				if (lhs == true || rhs == true) return true;
+				break;
+			case Connective::implication:
+				if (lhs == false || rhs == true) return true;
+				break;
+			case Connective::biimplication:
+			case Connective::negation:
+				break;
+		}
+
+		if (not lhs.has_value() || not rhs.has_value()) return std::nullopt;
+
+		/* both sides are known */
+		switch (*connective) {
+			case Connective::conjunction:
+				return *lhs and *rhs;
+			case Connective::disjunction:
+				return *lhs or *rhs;
+			case Connective::implication:
+				return (not *lhs) or *rhs;
+			default:
+				return *lhs == *rhs;
+		}
+	}
+
+	const std::vector<std::string>& Formula::get_variables() const {
+		return variables;
+	}
+
 	std::string Formula::tabulate() const {
 		if (variables.size() > 64) {
 			throw std::out_of_range("Formula contains too many variables to tabulate.");
 		}
 
+		auto indices = variable_indices();
 		Interpretation I;
 		std::stringstream repr;
 
 		for (std::size_t i = 0; i < 1 << variables.size(); i++) {
 			std::bitset<64> valuations(i);
-			size_t index = 0;
-			for (const auto & variable : variables) {
-				I[variable] = valuations[index++];
+			for (size_t index = 0; index < indices.size(); index++) {
+				I.set(indices[index], valuations[index]);
 			}
 
 			repr << I << ": " << eval(I) << "\n";
@@ -286,14 +645,14 @@ namespace logic {
 			throw std::out_of_range("Formula contains too many variables to satisfy like this.");
 		}
 
+		auto indices = variable_indices();
 		Interpretation I;
 		std::stringstream repr;
 
 		for (std::size_t i = 0; i < 1 << variables.size(); i++) {
 			std::bitset<64> valuations(i);
-			size_t index = 0;
-			for (const auto & variable : variables) {
-				I[variable] = valuations[index++];
+			for (size_t index = 0; index < indices.size(); index++) {
+				I.set(indices[index], valuations[index]);
 			}
 
 			if (eval(I)) return I;
@@ -333,12 +692,12 @@ namespace logic {
 
 		std::size_t count = 0;
 
+		auto indices = variable_indices();
 		Interpretation I;
 		for (std::size_t i = 0; i < 1 << variables.size(); i++) {
 			std::bitset<64> valuations(i);
-			size_t index = 0;
-			for (const auto & variable : variables) {
-				I[variable] = valuations[index++];
+			for (size_t index = 0; index < indices.size(); index++) {
+				I.set(indices[index], valuations[index]);
 			}
 
 			if (eval(I)) count++;
@@ -348,22 +707,20 @@ namespace logic {
 	}
 
 	bool Formula::is_parity_check() const {
-		/* test whether the formula is a tautology  */
-		if (variables.size() > 64) {
-			throw std::out_of_range("Formula contains too many variables to test like this.");
-		}
-
-		Interpretation I;
-		for (std::size_t i = 0; i < 1 << variables.size(); i++) {
-			std::bitset<64> valuations(i);
-			size_t index = 0;
-			for (const auto & variable : variables) {
-				I[variable] = valuations[index++];
-			}
-
-			if (eval(I) && I.count_satisfied() % 2 != 0) return false;
+		/* a parity check formula is only true under interpretations with an even number of true variables */
+		if (auto affine = ANF::affine_form(*this)) {
+			/*
+			 * c ⊕ x1 ⊕ ... ⊕ xk over the formula's variables V:
+			 *   k = 0    - a constant, which must be false unless there is nothing to assign
+			 *   all of V - exactly the even interpretations when c is true
+			 *   else     - flipping a variable outside of the sum changes the parity but not the valuation
+			 */
+			if (affine->variables.empty()) return not affine->constant || variables.empty();
+			return affine->constant && affine->variables.size() == variables.size();
 		}
 
-		return true;
+		/* F ∧ (x1 ⊕ ... ⊕ xn) has to be the zero polynomial */
+		ANF anf(*this);
+		return (anf * ANF::parity(variables)).is_zero();
 	}
 }
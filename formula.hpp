@@ -1,12 +1,32 @@
 #pragma once
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace logic {
+	/*
+	 * process wide table of variable names
+	 *
+	 * every variable name is given a small dense index the first time it is seen,
+	 * atoms carry the index of their variable and interpretations store valuations at it.
+	 * Names are kept for the life of the process, one entry per distinct name.
+	 */
+	class VariableTable {
+	public:
+		/* index of a variable, adding it to the table if necessary */
+		static std::size_t intern(const std::string&);
+		static std::optional<std::size_t> find(const std::string&);
+
+		static const std::string& name(std::size_t);
+		static std::size_t size();
+	};
+
 	/* anonymous namespace to hide Atom struct */
 	namespace {
 		/* atom struct - an atomic formulae
@@ -20,9 +40,12 @@ namespace logic {
 				tautology,
 				contradiction,
 			} type;
+			/* index of the variable in the VariableTable */
+			std::size_t index;
 
 			/* atomic variable constructor */
-			Atom(std::string _name, AtomType _type) : name(_name), type(_type) { }
+			Atom(std::string _name, AtomType _type)
+				: name(_name), type(_type), index(_type == variable ? VariableTable::intern(_name) : 0) { }
 
 			std::string to_string() const {
 				switch (type) {
@@ -48,28 +71,97 @@ namespace logic {
 	/* expose AtomType from Atom */
 	using AtomType = Atom::AtomType;
 
-	/* a wrapper around std::unordered map */
+	/*
+	 * a valuation of some of the variables
+	 *
+	 * valuations are stored as packed bits at the variables' VariableTable indices,
+	 * so lookups are a shift and a mask. Only the words between the lowest and the
+	 * highest variable assigned are kept, so the size of an interpretation depends on
+	 * the range of its variables rather than on how many names have been interned.
+	 * The name based API interns the name and then uses the index.
+	 */
 	class Interpretation {
-		/* mapping from atom.name to its valuation */
-		std::unordered_map<std::string, bool> mapping;
+		/* the word holding variables 64 * first_word to 64 * first_word + 63 is stored first */
+		std::size_t first_word = 0;
+		/* bit i holds the valuation of variable 64 * first_word + i, it is clear if the variable is unassigned */
+		std::vector<std::uint64_t> values;
+		/* bit i is set if variable 64 * first_word + i has a valuation */
+		std::vector<std::uint64_t> assigned;
 
 	public:
+		/* proxy for a single valuation returned by operator[] */
+		class reference {
+			Interpretation& interpretation;
+			std::size_t index;
+
+		public:
+			reference(Interpretation& _interpretation, std::size_t _index)
+				: interpretation(_interpretation), index(_index) { }
+
+			operator bool() const;
+			reference& operator=(bool);
+			reference& operator=(const reference&);
+		};
+
+		/* iterates over the assigned variables in index order, yielding (name, valuation) pairs */
+		class const_iterator {
+		public:
+			using value_type = std::pair<const std::string&, bool>;
+			using difference_type = std::ptrdiff_t;
+
+		private:
+			const Interpretation* interpretation;
+			std::size_t index;
+			/* the pair most recently dereferenced */
+			mutable std::optional<value_type> current;
+
+		public:
+			const_iterator() = default;
+			const_iterator(const Interpretation*, std::size_t);
+
+			const value_type& operator*() const;
+			const_iterator& operator++();
+			const_iterator operator++(int);
+			bool operator==(const const_iterator&) const;
+		};
+
 		/* default constructor */
 		Interpretation() = default;
 
 		Interpretation(std::vector<std::pair<std::string, bool>>);
 
 		/* operator[] overloads */
-		bool& operator[](const std::string&);
-		bool& operator[](const Atom&);
+		reference operator[](const std::string&);
+		reference operator[](const Atom&);
+		reference operator[](std::size_t);
 
 		/* .at overloads */
 		bool at(const std::string&) const;
 		bool at(const Atom&) const;
+		bool at(std::size_t) const;
+
+		/* index based access */
+		void set(std::size_t, bool);
+		void flip(std::size_t);
+		void flip(const std::string&);
+		void erase(std::size_t);
+		bool contains(std::size_t) const;
+		bool contains(const std::string&) const;
 
 		friend std::ostream& operator<<(std::ostream&, const Interpretation&);
 
 		std::size_t count_satisfied() const;
+
+		/* number of assigned variables */
+		std::size_t size() const;
+		bool empty() const;
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		/* interpretations are equal if they assign the same variables the same valuations */
+		bool operator==(const Interpretation&) const;
+		std::size_t hash() const;
 	};
 
 	/*
@@ -113,6 +205,23 @@ namespace logic {
 		Formula(const Formula&, Connective, const Formula&); /* normal left side connective right side constructor */
 		Formula(Connective, const Formula&); /* constructor for negation */
 		Formula(Atom); /* atom constructor */
+		Formula(std::shared_ptr<const Formula>, Connective, std::shared_ptr<const Formula>); /* constructor from existing subformulas */
+
+		std::vector<std::size_t> variable_indices() const;
+
+		/* rewrite a shared subformula, returning the same pointer if nothing under it changes */
+		using SubstitutionMemo = std::unordered_map<const Formula*, std::shared_ptr<const Formula>>;
+		static std::shared_ptr<const Formula> substitute(
+			const std::shared_ptr<const Formula>&,
+			const std::unordered_map<std::string, Formula>&,
+			SubstitutionMemo&
+		);
+		bool mentions_any(const std::unordered_map<std::string, Formula>&) const;
+
+		/* the clause form encoder, truth tables and algebraic normal form walk the formula tree directly */
+		friend class CNF;
+		friend class ANF;
+		friend class TruthTable;
 
 	public:
 		/* atomic variable constructor */
@@ -123,6 +232,9 @@ namespace logic {
 		static Formula Tautology();
 		static Formula Contradiction();
 
+		/* the conjunction of the literals an interpretation assigns, ⊤ if it is empty */
+		static Formula Cube(const Interpretation&);
+
 		/* Parse a formula from a string expression */
 		/* static Formula Parse(std::string&); */
 
@@ -151,6 +263,14 @@ namespace logic {
 		/* other functions returning a new formula */
 		Formula replace(const std::string& varname, const Formula& replacement) const;
 
+		/* replace every variable in the map by its formula simultaneously
+		 * subformulas without any of the variables are shared with this formula */
+		Formula substitute(const std::unordered_map<std::string, Formula>&) const;
+
+		/* in-place variants of replace and substitute */
+		Formula& replace_in_place(const std::string& varname, const Formula& replacement);
+		Formula& substitute_in_place(const std::unordered_map<std::string, Formula>&);
+
 		/* stream output operator */
 		friend std::ostream& operator<<(std::ostream&, const Formula&);
 
@@ -160,6 +280,12 @@ namespace logic {
 		/* evaluate the formula under a given interpretaton */
 		bool eval(const Interpretation&) const;
 
+		/* three valued evaluation - empty if the result depends on an unassigned variable */
+		std::optional<bool> eval_partial(const Interpretation&) const;
+
+		/* the variables used in the formula, sorted by name */
+		const std::vector<std::string>& get_variables() const;
+
 		/* product a truth table for the formula */
 		std::string tabulate() const;
 
@@ -179,3 +305,11 @@ namespace logic {
 		bool is_parity_check() const;
 	};
 }
+
+/* allow interpretations to be used as keys in unordered containers */
+template<>
+struct std::hash<logic::Interpretation> {
+	std::size_t operator()(const logic::Interpretation& interpretation) const noexcept {
+		return interpretation.hash();
+	}
+};
@@ -0,0 +1,459 @@
+#include "minimize.hpp"
+#include "solver.hpp"
+#include "truth_table.hpp"
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_set>
+
+namespace logic {
+	namespace {
+		/* largest number of variables minimized exactly */
+		constexpr std::size_t exact_limit = 12;
+
+		/* search nodes spent looking for a smaller cover than the greedy one */
+		constexpr std::size_t node_limit = 100'000;
+
+		/* rounds of reduce, expand and irredundant done by the heuristic */
+		constexpr std::size_t max_iterations = 16;
+
+		/* a conjunction of literals - variable i is in the cube if bit i of mask is set,
+		 * its valuation is bit i of values */
+		struct Cube {
+			std::uint64_t mask;
+			std::uint64_t values;
+
+			bool operator==(const Cube&) const = default;
+
+			std::size_t num_literals() const {
+				return std::popcount(mask);
+			}
+
+			bool intersects(const Cube& other) const {
+				return ((values ^ other.values) & mask & other.mask) == 0;
+			}
+
+			/* every assignment in other is also in this cube */
+			bool contains(const Cube& other) const {
+				return (mask & ~other.mask) == 0 && ((values ^ other.values) & mask) == 0;
+			}
+		};
+
+		struct CubeHash {
+			std::size_t operator()(const Cube& cube) const {
+				return std::hash<std::uint64_t>{}(cube.mask * 0x9e3779b97f4a7c15 ^ cube.values);
+			}
+		};
+
+		/* a disjunction of cubes */
+		using Cover = std::vector<Cube>;
+
+		/* number of cubes, then number of literals */
+		std::pair<std::size_t, std::size_t> cost(const Cover& cover) {
+			std::size_t literals = 0;
+			for (const auto & cube : cover) literals += cube.num_literals();
+
+			return { cover.size(), literals };
+		}
+
+		/* Quine-McCluskey - merge cubes differing in a single variable until no more merge */
+		Cover prime_implicants(const TruthTable& table) {
+			std::uint64_t full = (std::uint64_t(1) << table.num_variables()) - 1;
+
+			Cover current;
+			for (std::uint64_t row = 0; row <= full; row++) {
+				if (table.at(row)) current.push_back({ full, row });
+			}
+
+			Cover primes;
+			while (not current.empty()) {
+				std::unordered_set<Cube, CubeHash> present(current.begin(), current.end()), merged, next;
+
+				/* the partner of a cube has a 1 where the cube has a 0 in the same position */
+				for (const auto & cube : current) {
+					for (auto zeros = cube.mask & ~cube.values; zeros != 0; zeros &= zeros - 1) {
+						auto bit = zeros & -zeros;
+						Cube partner = { cube.mask, cube.values | bit };
+						if (not present.contains(partner)) continue;
+
+						next.insert({ cube.mask & ~bit, cube.values });
+						merged.insert(cube);
+						merged.insert(partner);
+					}
+				}
+
+				for (const auto & cube : current) {
+					if (not merged.contains(cube)) primes.push_back(cube);
+				}
+				current.assign(next.begin(), next.end());
+			}
+
+			return primes;
+		}
+
+		/* a smallest subset of the primes covering every minterm, by branch and bound from a greedy cover */
+		Cover select_primes(const Cover& primes, const TruthTable& table) {
+			std::vector<std::uint64_t> minterms;
+			for (std::uint64_t row = 0; row < (std::uint64_t(1) << table.num_variables()); row++) {
+				if (table.at(row)) minterms.push_back(row);
+			}
+
+			/* the minterms of each prime as a bitset, and the primes of each minterm */
+			auto num_words = (minterms.size() + 63) / 64;
+			std::uint64_t full = (std::uint64_t(1) << table.num_variables()) - 1;
+			std::vector<std::vector<std::uint64_t>> coverage(primes.size(), std::vector<std::uint64_t>(num_words, 0));
+			std::vector<std::vector<std::size_t>> covering(minterms.size());
+			for (std::size_t p = 0; p < primes.size(); p++) {
+				for (std::size_t m = 0; m < minterms.size(); m++) {
+					if (not primes[p].contains({ full, minterms[m] })) continue;
+
+					coverage[p][m / 64] |= std::uint64_t(1) << (m % 64);
+					covering[m].push_back(p);
+				}
+			}
+
+			auto count_new = [&](std::size_t p, const std::vector<std::uint64_t>& uncovered) {
+				std::size_t count = 0;
+				for (std::size_t word = 0; word < num_words; word++) count += std::popcount(coverage[p][word] & uncovered[word]);
+				return count;
+			};
+
+			std::vector<std::uint64_t> everything(num_words, ~std::uint64_t(0));
+			if (minterms.size() % 64 != 0) everything.back() = (std::uint64_t(1) << (minterms.size() % 64)) - 1;
+
+			/* greedy - the prime covering the most new minterms, with the fewest literals */
+			std::vector<std::size_t> best;
+			auto uncovered = everything;
+			while (std::any_of(uncovered.begin(), uncovered.end(), [](std::uint64_t word) { return word != 0; })) {
+				std::size_t chosen = 0, most = 0;
+				for (std::size_t p = 0; p < primes.size(); p++) {
+					auto count = count_new(p, uncovered);
+					if (count > most || (count == most && count > 0 && primes[p].num_literals() < primes[chosen].num_literals())) {
+						chosen = p;
+						most = count;
+					}
+				}
+
+				best.push_back(chosen);
+				for (std::size_t word = 0; word < num_words; word++) uncovered[word] &= ~coverage[chosen][word];
+			}
+
+			auto literals = [&](const std::vector<std::size_t>& chosen) {
+				std::size_t total = 0;
+				for (auto p : chosen) total += primes[p].num_literals();
+				return total;
+			};
+			auto best_cost = std::make_pair(best.size(), literals(best));
+
+			/* branch on the primes of the uncovered minterm with the fewest of them, essential primes come first */
+			std::size_t nodes = 0;
+			std::vector<std::size_t> chosen;
+			std::function<void(const std::vector<std::uint64_t>&, std::size_t)> search = [&](const std::vector<std::uint64_t>& uncovered, std::size_t chosen_literals) {
+				if (nodes++ >= node_limit) return;
+
+				std::optional<std::size_t> hardest;
+				for (std::size_t word = 0; word < num_words; word++) {
+					for (auto bits = uncovered[word]; bits != 0; bits &= bits - 1) {
+						std::size_t m = 64 * word + std::countr_zero(bits);
+						if (not hardest.has_value() || covering[m].size() < covering[*hardest].size()) hardest = m;
+					}
+				}
+
+				if (not hardest.has_value()) {
+					auto found = std::make_pair(chosen.size(), chosen_literals);
+					if (found < best_cost) {
+						best = chosen;
+						best_cost = found;
+					}
+					return;
+				}
+
+				/* at least one more prime is needed */
+				if (std::make_pair(chosen.size() + 1, chosen_literals) >= best_cost) return;
+
+				for (auto p : covering[*hardest]) {
+					auto remaining = uncovered;
+					for (std::size_t word = 0; word < num_words; word++) remaining[word] &= ~coverage[p][word];
+
+					chosen.push_back(p);
+					search(remaining, chosen_literals + primes[p].num_literals());
+					chosen.pop_back();
+				}
+			};
+			search(everything, 0);
+
+			Cover cover;
+			for (auto p : best) cover.push_back(primes[p]);
+
+			return cover;
+		}
+
+		/* the cubes of the cover which intersect a cube, restricted to the variables outside it */
+		Cover cofactor(const Cover& cover, const Cube& cube) {
+			Cover result;
+			for (const auto & other : cover) {
+				if (other.intersects(cube)) result.push_back({ other.mask & ~cube.mask, other.values & ~cube.mask });
+			}
+
+			return result;
+		}
+
+		/* unate recursive paradigm - split on the most binate variable until the cover is unate */
+		bool tautology(const Cover& cover) {
+			if (cover.empty()) return false;
+
+			std::uint64_t positive = 0, negative = 0;
+			for (const auto & cube : cover) {
+				if (cube.mask == 0) return true;
+
+				positive |= cube.mask & cube.values;
+				negative |= cube.mask & ~cube.values;
+			}
+
+			/* a unate cover is a tautology only if it contains the universal cube */
+			auto binate = positive & negative;
+			if (binate == 0) return false;
+
+			std::size_t best = 0, most = 0;
+			for (auto bits = binate; bits != 0; bits &= bits - 1) {
+				auto variable = std::countr_zero(bits);
+				auto occurrences = std::count_if(cover.begin(), cover.end(), [&](const Cube& cube) {
+					return (cube.mask >> variable) & 1;
+				});
+
+				if (std::size_t(occurrences) > most) {
+					best = variable;
+					most = occurrences;
+				}
+			}
+
+			auto bit = std::uint64_t(1) << best;
+			return tautology(cofactor(cover, { bit, bit })) && tautology(cofactor(cover, { bit, 0 }));
+		}
+
+		/* every assignment in the cube is in the cover */
+		bool covers(const Cover& cover, const Cube& cube) {
+			return tautology(cofactor(cover, cube));
+		}
+
+		/* decides whether a cube implies the formula, using a solver loaded with its negation */
+		class ImplicantOracle {
+			const std::vector<std::string>& variables;
+			/* VariableTable index of each variable */
+			std::vector<std::size_t> indices;
+			Solver negation;
+
+		public:
+			ImplicantOracle(const Formula& formula, const std::vector<std::string>& _variables)
+				: variables(_variables), negation(not formula) {
+				for (const auto & variable : variables) indices.push_back(VariableTable::intern(variable));
+			}
+
+			Interpretation to_interpretation(const Cube& cube) const {
+				Interpretation I;
+				for (auto bits = cube.mask; bits != 0; bits &= bits - 1) {
+					auto position = std::countr_zero(bits);
+					I.set(indices[position], (cube.values >> position) & 1);
+				}
+
+				return I;
+			}
+
+			Cube to_cube(const Interpretation& I) const {
+				Cube cube = { 0, 0 };
+				for (std::size_t position = 0; position < indices.size(); position++) {
+					if (not I.contains(indices[position])) continue;
+
+					cube.mask |= std::uint64_t(1) << position;
+					if (I.at(indices[position])) cube.values |= std::uint64_t(1) << position;
+				}
+
+				return cube;
+			}
+
+			bool implies(const Cube& cube) {
+				return not negation.solve(to_interpretation(cube)).has_value();
+			}
+
+			/* raise the literals of an implicant while it stays one, starting from those the solver needed */
+			Cube expand(Cube cube) {
+				if (not implies(cube)) return cube;
+				cube = to_cube(negation.failed_assumptions());
+
+				for (auto bits = cube.mask; bits != 0; bits &= bits - 1) {
+					auto bit = bits & -bits;
+					Cube raised = { cube.mask & ~bit, cube.values & ~bit };
+					if (implies(raised)) cube = raised;
+				}
+
+				return cube;
+			}
+		};
+
+		/* expand every cube to a prime, dropping the cubes an earlier prime already contains */
+		Cover expand(Cover cover, ImplicantOracle& oracle) {
+			std::sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) { return a.num_literals() < b.num_literals(); });
+
+			Cover expanded;
+			for (auto cube : cover) {
+				bool contained = std::any_of(expanded.begin(), expanded.end(), [&](const Cube& other) { return other.contains(cube); });
+				if (contained) continue;
+
+				cube = oracle.expand(cube);
+
+				/* drop the earlier cubes the new prime swallows */
+				std::erase_if(expanded, [&](const Cube& other) { return cube.contains(other); });
+				expanded.push_back(cube);
+			}
+
+			return expanded;
+		}
+
+		/* drop cubes covered by the rest, smallest first */
+		Cover irredundant(Cover cover) {
+			std::sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) { return a.num_literals() > b.num_literals(); });
+
+			for (std::size_t i = 0; i < cover.size();) {
+				Cover others = cover;
+				others.erase(others.begin() + i);
+
+				if (covers(others, cover[i])) {
+					cover = std::move(others);
+				} else {
+					i++;
+				}
+			}
+
+			return cover;
+		}
+
+		/* shrink each cube to the part of it no other cube covers, so expand can move it elsewhere */
+		Cover reduce(Cover cover, std::uint64_t variables) {
+			for (std::size_t i = 0; i < cover.size(); i++) {
+				Cover others = cover;
+				others.erase(others.begin() + i);
+
+				auto& cube = cover[i];
+				for (auto bits = variables & ~cube.mask; bits != 0; bits &= bits - 1) {
+					auto bit = bits & -bits;
+
+					for (bool value : { false, true }) {
+						Cube half = { cube.mask | bit, value ? cube.values | bit : cube.values };
+						if (not covers(others, half)) continue;
+
+						cube = { cube.mask | bit, value ? cube.values : cube.values | bit };
+						break;
+					}
+				}
+			}
+
+			return cover;
+		}
+
+		Formula literal(const std::string& name, bool valuation) {
+			auto variable = Formula::PropVar(name.c_str());
+			return valuation ? variable : not variable;
+		}
+
+		/* the conjunction of the literals of a cube */
+		Formula cube_formula(const Cube& cube, const std::vector<std::string>& variables) {
+			std::optional<Formula> term;
+			for (auto bits = cube.mask; bits != 0; bits &= bits - 1) {
+				auto position = std::countr_zero(bits);
+				auto next = literal(variables[position], (cube.values >> position) & 1);
+				term = term.has_value() ? (*term and next) : next;
+			}
+
+			return term.value_or(Formula::Tautology());
+		}
+
+		/*
+		 * Espresso - an initial cover of primes, then reduce, expand and irredundant while it gets cheaper
+		 *
+		 * The off-set is never listed, whether a cube stays inside the formula is asked of the oracle.
+		 * The initial primes are grown from models which no earlier prime covers.
+		 */
+		Cover espresso(const Formula& formula, const std::vector<std::string>& variables) {
+			ImplicantOracle oracle(formula, variables);
+
+			Solver uncovered(formula);
+			for (const auto & variable : variables) uncovered.declare(variable);
+
+			Cover cover;
+			while (auto model = uncovered.solve()) {
+				auto prime = oracle.expand(oracle.to_cube(*model));
+				cover.push_back(prime);
+				uncovered.add(not cube_formula(prime, variables));
+			}
+
+			auto all = variables.size() == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << variables.size()) - 1;
+			cover = irredundant(cover);
+
+			for (std::size_t iteration = 0; iteration < max_iterations; iteration++) {
+				auto next = irredundant(expand(reduce(cover, all), oracle));
+				if (cost(next) >= cost(cover)) break;
+
+				cover = std::move(next);
+			}
+
+			return cover;
+		}
+
+	}
+
+	Formula minimize(const Formula& formula, NormalForm form) {
+		const auto & variables = formula.get_variables();
+		if (variables.size() > 64) {
+			throw std::out_of_range("Formula contains too many variables to minimize.");
+		}
+
+		/* a conjunctive form is built from the disjunctive form of the negation */
+		bool conjunctive = form == NormalForm::conjunctive;
+		auto target = conjunctive ? not formula : formula;
+
+		Cover cover;
+		if (variables.size() <= exact_limit) {
+			TruthTable table(target);
+			cover = select_primes(prime_implicants(table), table);
+		} else {
+			cover = espresso(target, variables);
+		}
+
+		/* a stable order, independent of how the cubes were found */
+		std::sort(cover.begin(), cover.end(), [](const Cube& a, const Cube& b) {
+			return std::tie(a.mask, a.values) < std::tie(b.mask, b.values);
+		});
+
+		/* each cube is a term, or the negation of a clause */
+		std::optional<Formula> result;
+		for (const auto & cube : cover) {
+			std::optional<Formula> term;
+			for (std::size_t position = 0; position < variables.size(); position++) {
+				if (not ((cube.mask >> position) & 1)) continue;
+
+				bool valuation = (cube.values >> position) & 1;
+				auto next = literal(variables[position], valuation != conjunctive);
+				if (not term.has_value()) {
+					term = next;
+				} else {
+					term = conjunctive ? (*term or next) : (*term and next);
+				}
+			}
+
+			/* the universal cube */
+			if (not term.has_value()) return conjunctive ? Formula::Contradiction() : Formula::Tautology();
+
+			if (not result.has_value()) {
+				result = term;
+			} else {
+				result = conjunctive ? (*result and *term) : (*result or *term);
+			}
+		}
+
+		if (not result.has_value()) return conjunctive ? Formula::Tautology() : Formula::Contradiction();
+		return *result;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "formula.hpp"
+
+namespace logic {
+	enum class NormalForm {
+		/* a disjunction of conjunctions of literals */
+		disjunctive,
+		/* a conjunction of disjunctions of literals */
+		conjunctive,
+	};
+
+	/*
+	 * a small equivalent formula in disjunctive or conjunctive normal form
+	 *
+	 * Formulas of up to 12 variables are minimized with Quine-McCluskey: every
+	 * prime implicant is generated from the truth table and a smallest set covering
+	 * it is searched for by branch and bound, starting from a greedy cover. The
+	 * search is limited to 100000 nodes - if it finishes within them the cover is
+	 * minimal, otherwise the best one found so far is used, which may be the greedy
+	 * one. Up to 64 variables an Espresso style loop of expanding cubes to primes,
+	 * dropping redundant ones and reducing them again is used instead, with a
+	 * Solver deciding which cubes imply the formula.
+	 *
+	 * Cubes are counted first and literals second. The conjunctive form is the
+	 * negation of the minimized disjunctive form of the negated formula.
+	 */
+	Formula minimize(const Formula&, NormalForm = NormalForm::disjunctive);
+}
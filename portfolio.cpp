@@ -0,0 +1,200 @@
+#include "portfolio.hpp"
+#include <algorithm>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace logic {
+	namespace {
+		/* probability of a random walk step when every flip breaks a clause */
+		constexpr double noise = 0.567;
+
+		/* WalkSAT - flip variables of falsified clauses until none are left or stop is set */
+		std::optional<std::vector<bool>> walksat(const std::vector<Clause>& clauses, std::size_t num_variables,
+			std::uint64_t seed, const std::atomic<bool>& stop) {
+			std::mt19937_64 random(seed);
+
+			std::vector<std::vector<std::uint32_t>> occurrences(2 * num_variables);
+			for (std::uint32_t index = 0; index < clauses.size(); index++) {
+				if (clauses[index].empty()) return std::nullopt;
+				for (auto literal : clauses[index]) occurrences[literal.code].push_back(index);
+			}
+
+			std::vector<bool> values(num_variables);
+			for (std::size_t variable = 0; variable < num_variables; variable++) values[variable] = random() & 1;
+
+			/* number of true literals of each clause, and the falsified clauses */
+			std::vector<std::uint32_t> true_count(clauses.size(), 0);
+			std::vector<std::uint32_t> falsified;
+			std::vector<std::int64_t> position(clauses.size(), -1);
+
+			auto falsify = [&](std::uint32_t index) {
+				position[index] = falsified.size();
+				falsified.push_back(index);
+			};
+			auto satisfy = [&](std::uint32_t index) {
+				auto last = falsified.back();
+				falsified[position[index]] = last;
+				position[last] = position[index];
+				falsified.pop_back();
+				position[index] = -1;
+			};
+
+			for (std::uint32_t index = 0; index < clauses.size(); index++) {
+				for (auto literal : clauses[index]) true_count[index] += values[literal.variable()] != literal.negated();
+				if (true_count[index] == 0) falsify(index);
+			}
+
+			for (std::size_t flips = 0; not falsified.empty(); flips++) {
+				if (flips % 1024 == 0 && stop.load(std::memory_order_relaxed)) return std::nullopt;
+
+				/* the clauses broken by making a literal of a falsified clause true */
+				const auto & clause = clauses[falsified[random() % falsified.size()]];
+				Literal chosen = clause.front();
+				std::size_t least = SIZE_MAX;
+				for (auto literal : clause) {
+					std::size_t breaks = 0;
+					for (auto index : occurrences[(~literal).code]) breaks += true_count[index] == 1;
+
+					if (breaks < least) {
+						least = breaks;
+						chosen = literal;
+					}
+				}
+
+				if (least > 0 && std::uniform_real_distribution<double>(0, 1)(random) < noise) {
+					chosen = clause[random() % clause.size()];
+				}
+
+				values[chosen.variable()] = not chosen.negated();
+				for (auto index : occurrences[chosen.code]) {
+					if (true_count[index]++ == 0) satisfy(index);
+				}
+				for (auto index : occurrences[(~chosen).code]) {
+					if (--true_count[index] == 0) falsify(index);
+				}
+			}
+
+			return values;
+		}
+	}
+
+	void ClauseExchange::publish(const Clause& clause) {
+		if (clause.empty() || clause.size() > 2) return;
+
+		std::uint64_t packed = std::uint64_t(clause[0].code + 1) << 32;
+		if (clause.size() == 2) packed |= clause[1].code + 1;
+
+		auto index = head.fetch_add(1, std::memory_order_relaxed);
+		slots[index % capacity].store(packed, std::memory_order_release);
+	}
+
+	std::vector<Clause> ClauseExchange::collect(std::uint64_t& cursor) const {
+		auto end = head.load(std::memory_order_acquire);
+
+		/* anything further back has been overwritten */
+		if (end - cursor > capacity) cursor = end - capacity;
+
+		std::vector<Clause> clauses;
+		for (; cursor < end; cursor++) {
+			auto packed = slots[cursor % capacity].load(std::memory_order_acquire);
+			if (packed == 0) continue;
+
+			Clause clause = { Literal::from_code((packed >> 32) - 1) };
+			if (packed & 0xFFFFFFFF) clause.push_back(Literal::from_code((packed & 0xFFFFFFFF) - 1));
+			clauses.push_back(std::move(clause));
+		}
+
+		return clauses;
+	}
+
+	Portfolio::Portfolio(const Formula& _formula, PortfolioOptions _options)
+		: formula(_formula), options(_options) { }
+
+	SolverOptions Portfolio::configuration(std::size_t index) {
+		SolverOptions configuration;
+		configuration.seed = index;
+
+		switch (index % 4) {
+			case 0:
+				break;
+			case 1:
+				configuration.restarts = RestartPolicy::geometric;
+				configuration.initial_phase = true;
+				break;
+			case 2:
+				configuration.random_frequency = 0.02;
+				configuration.variable_decay = 0.9;
+				break;
+			case 3:
+				configuration.restarts = RestartPolicy::geometric;
+				configuration.random_frequency = 0.01;
+				configuration.variable_decay = 0.8;
+				configuration.initial_phase = true;
+				break;
+		}
+
+		return configuration;
+	}
+
+	std::optional<Interpretation> Portfolio::solve() {
+		std::size_t num_threads = options.num_threads;
+		if (num_threads == 0) num_threads = std::max(2u, std::thread::hardware_concurrency());
+
+		/* local search can't show unsatisfiability, so there is always a complete engine */
+		bool local_search = options.local_search && num_threads > 1;
+		auto num_solvers = num_threads - local_search;
+
+		std::atomic<bool> stop = false;
+		ClauseExchange exchange;
+
+		std::mutex mutex;
+		std::optional<Interpretation> answer;
+		bool answered = false;
+
+		auto finish = [&](std::optional<Interpretation> result, std::string engine) {
+			std::lock_guard lock(mutex);
+			if (answered) return;
+
+			answered = true;
+			answer = std::move(result);
+			winner = std::move(engine);
+			stop = true;
+		};
+
+		std::vector<std::thread> threads;
+		for (std::size_t index = 0; index < num_solvers; index++) {
+			threads.emplace_back([&, index] {
+				auto configuration = Portfolio::configuration(index);
+				configuration.stop = &stop;
+				if (options.share_clauses) configuration.exchange = &exchange;
+
+				Solver solver(formula, configuration);
+				auto model = solver.solve();
+				if (not solver.interrupted()) finish(std::move(model), "solver " + std::to_string(index));
+			});
+		}
+
+		if (local_search) {
+			threads.emplace_back([&] {
+				CNF problem(formula);
+				auto values = walksat(problem.get_clauses(), problem.num_variables(), num_threads, stop);
+				if (not values.has_value()) return;
+
+				Interpretation model;
+				for (std::uint32_t variable = 0; variable < problem.num_variables(); variable++) {
+					if (not problem.is_auxiliary(variable)) model[problem.name(variable)] = (*values)[variable];
+				}
+				finish(std::move(model), "local search");
+			});
+		}
+
+		for (auto & thread : threads) thread.join();
+
+		return answer;
+	}
+
+	const std::string& Portfolio::get_winner() const {
+		return winner;
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "cnf.hpp"
+#include "formula.hpp"
+#include "solver.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace logic {
+	/*
+	 * a lock free buffer of short learnt clauses shared between solvers
+	 *
+	 * A clause of one or two literals is packed into a single word, so publishing is
+	 * an atomic increment and an atomic store. Each reader keeps its own cursor and
+	 * skips whatever was overwritten before it got there. A slot read late holds a
+	 * newer clause learnt from the same formulas, which is just as valid.
+	 */
+	class ClauseExchange {
+		static constexpr std::size_t capacity = 4096;
+
+		/* literal codes plus one in the upper and lower half, 0 if never written */
+		std::array<std::atomic<std::uint64_t>, capacity> slots {};
+		/* number of clauses ever published */
+		std::atomic<std::uint64_t> head = 0;
+
+	public:
+		/* clauses longer than two literals are ignored */
+		void publish(const Clause&);
+
+		/* the clauses published since cursor, which is moved past them */
+		std::vector<Clause> collect(std::uint64_t& cursor) const;
+	};
+
+	struct PortfolioOptions {
+		/* number of threads to use, 0 for one per core */
+		std::size_t num_threads = 0;
+		/* dedicate one of the threads to local search */
+		bool local_search = true;
+		/* let the complete solvers exchange unit and binary learnt clauses */
+		bool share_clauses = true;
+	};
+
+	/*
+	 * several differently configured engines racing on the same formula
+	 *
+	 * Every thread but one runs a CDCL Solver with its own seed, decision heuristic and
+	 * restart policy, and the last runs WalkSAT local search which can only find models.
+	 * The first definite answer wins, the other engines see the stop flag at their
+	 * next restart or decision and give up.
+	 */
+	class Portfolio {
+		Formula formula;
+		PortfolioOptions options;
+		std::string winner;
+
+	public:
+		Portfolio(const Formula&, PortfolioOptions = {});
+
+		/* a model, or nothing if the formula is unsatisfiable */
+		std::optional<Interpretation> solve();
+
+		/* the engine which answered the last call to solve */
+		const std::string& get_winner() const;
+
+		/* the search parameters of complete engine number index */
+		static SolverOptions configuration(std::size_t index);
+	};
+}
@@ -0,0 +1,381 @@
+#include "preprocess.hpp"
+#include <algorithm>
+
+namespace logic {
+	namespace {
+		/* the work each stage may do before giving up */
+		constexpr std::size_t step_limit = 20'000'000;
+
+		/* variables occurring in more clauses than this are too expensive to eliminate */
+		constexpr std::size_t elimination_limit = 32;
+
+		/* number of simplification rounds done by run */
+		constexpr std::size_t max_rounds = 3;
+
+		void erase_occurrence(std::vector<std::uint32_t>& occurrences, std::uint32_t index) {
+			auto it = std::find(occurrences.begin(), occurrences.end(), index);
+			*it = occurrences.back();
+			occurrences.pop_back();
+		}
+	}
+
+	void ReconstructionStack::push(Literal witness, Clause clause) {
+		entries.emplace_back(witness, std::move(clause));
+	}
+
+	void ReconstructionStack::extend(std::vector<bool>& model) const {
+		for (auto it = entries.rbegin(); it != entries.rend(); it++) {
+			const auto & [witness, clause] = *it;
+
+			bool satisfied = std::any_of(clause.begin(), clause.end(), [&](Literal literal) {
+				return model[literal.variable()] != literal.negated();
+			});
+			if (not satisfied) model[witness.variable()] = not witness.negated();
+		}
+	}
+
+	bool ReconstructionStack::empty() const {
+		return entries.empty();
+	}
+
+	Preprocessor::Preprocessor(std::size_t num_variables, ReconstructionStack& _reconstruction)
+		: occurrences(2 * num_variables), value(num_variables, -1), frozen(num_variables, false),
+		  eliminated(num_variables, false), marked(2 * num_variables, false), reconstruction(_reconstruction) { }
+
+	void Preprocessor::add_clause(Clause literals) {
+		if (not ok) return;
+
+		std::sort(literals.begin(), literals.end(), [](Literal a, Literal b) { return a.code < b.code; });
+
+		/* drop duplicates and fixed literals, skip tautologies and satisfied clauses */
+		std::size_t kept = 0;
+		for (auto literal : literals) {
+			auto valuation = value[literal.variable()];
+			if (valuation == not literal.negated() || (kept > 0 && literals[kept - 1] == ~literal)) return;
+			if (valuation >= 0 || (kept > 0 && literals[kept - 1] == literal)) continue;
+			literals[kept++] = literal;
+		}
+		literals.resize(kept);
+
+		if (literals.empty()) {
+			ok = false;
+		} else if (literals.size() == 1) {
+			assign(literals.front());
+		} else {
+			store(std::move(literals));
+		}
+	}
+
+	void Preprocessor::freeze(std::uint32_t variable) {
+		frozen[variable] = true;
+	}
+
+	bool Preprocessor::is_eliminated(std::uint32_t variable) const {
+		return eliminated[variable];
+	}
+
+	void Preprocessor::store(Clause literals) {
+		std::uint32_t index = clauses.size();
+		for (auto literal : literals) {
+			occurrences[literal.code].push_back(index);
+		}
+
+		clauses.push_back({ std::move(literals), false });
+		added.push_back(index);
+	}
+
+	void Preprocessor::remove(std::uint32_t index) {
+		auto& clause = clauses[index];
+		for (auto literal : clause.literals) {
+			erase_occurrence(occurrences[literal.code], index);
+		}
+
+		clause.deleted = true;
+		clause.literals = {};
+	}
+
+	/* remove a literal from a clause */
+	void Preprocessor::strengthen(std::uint32_t index, Literal literal) {
+		auto& literals = clauses[index].literals;
+		literals.erase(std::find(literals.begin(), literals.end(), literal));
+		erase_occurrence(occurrences[literal.code], index);
+
+		if (literals.size() == 1) {
+			auto unit = literals.front();
+			remove(index);
+			assign(unit);
+		} else {
+			added.push_back(index);
+		}
+	}
+
+	void Preprocessor::assign(Literal literal) {
+		auto& valuation = value[literal.variable()];
+		if (valuation >= 0) {
+			if (valuation == literal.negated()) ok = false;
+			return;
+		}
+
+		valuation = not literal.negated();
+		units.push_back(literal);
+	}
+
+	/* apply the pending units - satisfied clauses go, falsified literals are removed */
+	bool Preprocessor::propagate_units() {
+		while (ok && not units.empty()) {
+			auto literal = units.back();
+			units.pop_back();
+
+			auto satisfied = occurrences[literal.code];
+			for (auto index : satisfied) remove(index);
+
+			auto falsified = occurrences[(~literal).code];
+			for (auto index : falsified) strengthen(index, ~literal);
+		}
+
+		return ok;
+	}
+
+	/* remove the clauses a clause subsumes, and strengthen those it resolves with to a subset */
+	void Preprocessor::subsume(std::uint32_t index) {
+		const auto & literals = clauses[index].literals;
+
+		/* any clause it subsumes contains the rarest of its variables */
+		auto rarest = *std::min_element(literals.begin(), literals.end(), [&](Literal a, Literal b) {
+			return occurrences[a.code].size() + occurrences[(~a).code].size()
+				< occurrences[b.code].size() + occurrences[(~b).code].size();
+		});
+
+		auto candidates = occurrences[rarest.code];
+		const auto & negative = occurrences[(~rarest).code];
+		candidates.insert(candidates.end(), negative.begin(), negative.end());
+
+		for (auto literal : literals) marked[literal.code] = true;
+
+		for (auto candidate : candidates) {
+			const auto & other = clauses[candidate];
+			if (candidate == index || other.deleted || other.literals.size() < literals.size()) continue;
+			steps += other.literals.size();
+
+			std::size_t matched = 0, flipped = 0;
+			Literal resolved;
+			for (auto literal : other.literals) {
+				if (marked[literal.code]) {
+					matched++;
+				} else if (marked[(~literal).code]) {
+					flipped++;
+					resolved = literal;
+				}
+			}
+
+			if (matched + flipped != literals.size()) continue;
+
+			if (flipped == 0) {
+				remove(candidate);
+			} else if (flipped == 1) {
+				/* resolving on the flipped literal gives a subset of the other clause */
+				strengthen(candidate, resolved);
+			}
+		}
+
+		for (auto literal : literals) marked[literal.code] = false;
+	}
+
+	bool Preprocessor::subsumption() {
+		/* shorter clauses subsume more, so they go first */
+		std::sort(added.begin(), added.end(), [&](std::uint32_t a, std::uint32_t b) {
+			return clauses[a].literals.size() > clauses[b].literals.size();
+		});
+
+		/* also runs inside elimination, which keeps its own count */
+		auto start = steps;
+		while (not added.empty() && steps - start < step_limit) {
+			auto index = added.back();
+			added.pop_back();
+
+			if (not clauses[index].deleted) subsume(index);
+			if (not propagate_units()) return false;
+		}
+		added.clear();
+
+		return true;
+	}
+
+	bool Preprocessor::fails(Literal literal) {
+		std::vector<Literal> trail = { literal };
+		value[literal.variable()] = not literal.negated();
+
+		bool conflict = false;
+		for (std::size_t head = 0; head < trail.size() && not conflict; head++) {
+			auto falsified = ~trail[head];
+
+			for (auto index : occurrences[falsified.code]) {
+				const auto & literals = clauses[index].literals;
+				steps += literals.size();
+
+				/* the clause is unit or conflicting if it has at most one unassigned literal */
+				std::size_t unassigned = 0;
+				bool satisfied = false;
+				std::optional<Literal> implied;
+				for (auto other : literals) {
+					auto valuation = value[other.variable()];
+					if (valuation < 0) {
+						unassigned++;
+						implied = other;
+					} else if (valuation != other.negated()) {
+						satisfied = true;
+						break;
+					}
+				}
+
+				if (satisfied || unassigned > 1) continue;
+				if (not implied.has_value()) {
+					conflict = true;
+					break;
+				}
+
+				value[implied->variable()] = not implied->negated();
+				trail.push_back(*implied);
+			}
+		}
+
+		for (auto assigned : trail) value[assigned.variable()] = -1;
+
+		return conflict;
+	}
+
+	/* a literal whose propagation fails can only be false */
+	bool Preprocessor::probe() {
+		steps = 0;
+		for (std::uint32_t variable = 0; variable < value.size() && steps < step_limit; variable++) {
+			for (bool negated : { false, true }) {
+				Literal literal(variable, negated);
+
+				/* only literals that imply something through a binary clause are worth probing */
+				const auto & implications = occurrences[(~literal).code];
+				bool binary = std::any_of(implications.begin(), implications.end(), [&](std::uint32_t index) {
+					return clauses[index].literals.size() == 2;
+				});
+				if (value[variable] >= 0 || not binary) continue;
+
+				if (fails(literal)) {
+					assign(~literal);
+					if (not propagate_units()) return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	/* replace the clauses of a variable by all their resolvents, if there are no more of those */
+	bool Preprocessor::eliminate(std::uint32_t variable) {
+		if (frozen[variable] || eliminated[variable] || value[variable] >= 0) return false;
+
+		auto positive = occurrences[Literal(variable).code];
+		auto negative = occurrences[Literal(variable, true).code];
+		if (positive.empty() && negative.empty()) return false;
+		if (positive.size() + negative.size() > elimination_limit) return false;
+
+		std::vector<Clause> resolvents;
+		for (auto p : positive) {
+			for (auto literal : clauses[p].literals) marked[literal.code] = true;
+
+			for (auto n : negative) {
+				steps += clauses[n].literals.size();
+
+				Clause resolvent;
+				bool tautology = false;
+				for (auto literal : clauses[n].literals) {
+					if (literal.variable() == variable || marked[literal.code]) continue;
+					if (marked[(~literal).code]) {
+						tautology = true;
+						break;
+					}
+					resolvent.push_back(literal);
+				}
+				if (tautology) continue;
+
+				for (auto literal : clauses[p].literals) {
+					if (literal.variable() != variable) resolvent.push_back(literal);
+				}
+				resolvents.push_back(std::move(resolvent));
+			}
+
+			for (auto literal : clauses[p].literals) marked[literal.code] = false;
+
+			if (resolvents.size() > positive.size() + negative.size()) return false;
+		}
+
+		for (auto index : positive) {
+			reconstruction.push(Literal(variable), clauses[index].literals);
+			remove(index);
+		}
+		for (auto index : negative) {
+			reconstruction.push(Literal(variable, true), clauses[index].literals);
+			remove(index);
+		}
+		eliminated[variable] = true;
+
+		for (auto & resolvent : resolvents) {
+			add_clause(std::move(resolvent));
+		}
+
+		return true;
+	}
+
+	bool Preprocessor::elimination() {
+		/* cheapest variables first */
+		std::vector<std::uint32_t> order;
+		for (std::uint32_t variable = 0; variable < value.size(); variable++) {
+			if (not frozen[variable] && not eliminated[variable] && value[variable] < 0) order.push_back(variable);
+		}
+
+		auto cost = [&](std::uint32_t variable) {
+			return occurrences[Literal(variable).code].size() * occurrences[Literal(variable, true).code].size();
+		};
+		std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) { return cost(a) < cost(b); });
+
+		steps = 0;
+		for (auto variable : order) {
+			if (steps >= step_limit) break;
+			if (not eliminate(variable)) continue;
+
+			/* resolvents can subsume other clauses */
+			if (not propagate_units() || not subsumption()) return false;
+		}
+
+		return true;
+	}
+
+	bool Preprocessor::run() {
+		if (not propagate_units()) return false;
+
+		for (std::size_t round = 0; round < max_rounds; round++) {
+			auto num_eliminated = std::count(eliminated.begin(), eliminated.end(), true);
+
+			if (not subsumption() || not probe() || not elimination()) return false;
+
+			if (std::count(eliminated.begin(), eliminated.end(), true) == num_eliminated) break;
+		}
+
+		return true;
+	}
+
+	std::vector<Clause> Preprocessor::release_clauses() {
+		if (not ok) return { Clause() };
+
+		std::vector<Clause> simplified;
+		for (auto & clause : clauses) {
+			if (not clause.deleted) simplified.push_back(std::move(clause.literals));
+		}
+		for (std::uint32_t variable = 0; variable < value.size(); variable++) {
+			if (value[variable] >= 0) simplified.push_back({ Literal(variable, value[variable] == 0) });
+		}
+
+		clauses.clear();
+		for (auto & list : occurrences) list.clear();
+
+		return simplified;
+	}
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "cnf.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace logic {
+	/*
+	 * the clauses removed by variable elimination, each with the literal which repairs it
+	 *
+	 * A model of the simplified clauses is extended to a model of the original ones by
+	 * going through the stack backwards and flipping the witness of every falsified clause.
+	 */
+	class ReconstructionStack {
+		std::vector<std::pair<Literal, Clause>> entries;
+
+	public:
+		void push(Literal witness, Clause);
+
+		/* model is indexed by variable */
+		void extend(std::vector<bool>& model) const;
+
+		bool empty() const;
+	};
+
+	/*
+	 * simplification of a clause set before solving
+	 *
+	 * Clauses are kept in occurrence lists, and run applies in turn:
+	 *   - removal of tautologies, duplicate literals and clauses satisfied by units
+	 *   - backward subsumption and self-subsuming resolution
+	 *   - failed literal probing
+	 *   - bounded variable elimination, which never increases the number of clauses
+	 *
+	 * The result is equisatisfiable with the input, models are brought back to
+	 * the original variables with the reconstruction stack. Frozen variables are
+	 * never eliminated, so they can still be used afterwards.
+	 */
+	class Preprocessor {
+		struct StoredClause {
+			Clause literals;
+			bool deleted;
+		};
+
+		std::vector<StoredClause> clauses;
+		/* indexed by literal code, the live clauses containing that literal */
+		std::vector<std::vector<std::uint32_t>> occurrences;
+
+		/* per variable state, value is -1 unless the variable is fixed by a unit */
+		std::vector<std::int8_t> value;
+		std::vector<bool> frozen;
+		std::vector<bool> eliminated;
+		/* scratch marks indexed by literal code, clear between uses */
+		std::vector<bool> marked;
+
+		/* units still to be applied to the clauses */
+		std::vector<Literal> units;
+		/* clauses to use for subsumption */
+		std::vector<std::uint32_t> added;
+
+		ReconstructionStack& reconstruction;
+		/* false once the empty clause is derived */
+		bool ok = true;
+		/* rough count of work done, each stage stops when it runs out */
+		std::size_t steps = 0;
+
+		void store(Clause);
+		void remove(std::uint32_t);
+		void strengthen(std::uint32_t, Literal);
+		void assign(Literal);
+		bool propagate_units();
+
+		void subsume(std::uint32_t);
+		bool subsumption();
+
+		/* true if assuming the literal leads to a conflict by unit propagation */
+		bool fails(Literal);
+		bool probe();
+
+		bool eliminate(std::uint32_t);
+		bool elimination();
+
+	public:
+		Preprocessor(std::size_t num_variables, ReconstructionStack&);
+
+		void add_clause(Clause);
+		void freeze(std::uint32_t);
+
+		/* simplify until nothing changes, false if the clauses are unsatisfiable */
+		bool run();
+
+		bool is_eliminated(std::uint32_t) const;
+
+		/* the simplified clauses, including a unit for every fixed variable */
+		std::vector<Clause> release_clauses();
+	};
+}
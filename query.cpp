@@ -0,0 +1,127 @@
+#include "query.hpp"
+#include <bit>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace logic {
+	namespace {
+		/* the reason to stop a query, if there is one */
+		std::optional<QueryStatus> limit_reached(const QueryOptions& options, const QueryProgress& progress, std::uint64_t evaluated) {
+			if (options.token.cancelled() || progress.cancelled.load(std::memory_order_relaxed)) return QueryStatus::cancelled;
+			if (options.budget.has_value() && evaluated >= *options.budget) return QueryStatus::budget_exhausted;
+			if (options.deadline.has_value() && std::chrono::steady_clock::now() >= *options.deadline) return QueryStatus::timeout;
+
+			return std::nullopt;
+		}
+
+		/*
+		 * evaluate the interpretations in counting order until visit returns false
+		 * moving to the next interpretation only flips its trailing bits, two on average
+		 */
+		template<typename T, typename Visit>
+		void sweep(const Formula& formula, const QueryOptions& options, QueryProgress& progress, QueryResult<T>& result, Visit visit) {
+			if (auto reason = limit_reached(options, progress, 0)) {
+				result.status = *reason;
+				return;
+			}
+
+			std::vector<std::size_t> indices;
+			Interpretation I;
+			for (const auto & variable : formula.get_variables()) {
+				indices.push_back(VariableTable::intern(variable));
+				I.set(indices.back(), false);
+			}
+
+			auto last_row = indices.size() == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << indices.size()) - 1;
+			for (std::uint64_t row = 0;; row++) {
+				bool valuation = formula.eval(I);
+				result.evaluated++;
+				if (valuation) result.satisfied++;
+				progress.evaluated.store(result.evaluated, std::memory_order_relaxed);
+
+				if (not visit(I, valuation) || row == last_row) break;
+
+				if (auto reason = limit_reached(options, progress, result.evaluated)) {
+					result.status = *reason;
+					break;
+				}
+
+				for (std::size_t bit = 0; bit <= std::size_t(std::countr_zero(row + 1)); bit++) {
+					I.flip(indices[bit]);
+				}
+			}
+
+			result.last = std::move(I);
+		}
+
+		template<typename T, typename Run>
+		Query<T> launch(const Formula& formula, QueryOptions options, Run run) {
+			if (formula.get_variables().size() > 64) {
+				throw std::out_of_range("Formula contains too many variables to query like this.");
+			}
+
+			auto progress = std::make_shared<QueryProgress>();
+			progress->total = std::ldexp(1.0L, formula.get_variables().size());
+
+			auto result = std::async(std::launch::async, [formula, options, progress, run] {
+				QueryResult<T> result;
+				run(formula, options, *progress, result);
+				return result;
+			});
+
+			return Query<T>(progress, std::move(result));
+		}
+	}
+
+	void CancellationToken::cancel() const {
+		flag->store(true, std::memory_order_relaxed);
+	}
+
+	bool CancellationToken::cancelled() const {
+		return flag->load(std::memory_order_relaxed);
+	}
+
+	Query<std::optional<Interpretation>> satisfy_async(const Formula& formula, QueryOptions options) {
+		using Model = std::optional<Interpretation>;
+
+		return launch<Model>(formula, options, [](const Formula& formula, const QueryOptions& options, QueryProgress& progress, QueryResult<Model>& result) {
+			Model model;
+			sweep(formula, options, progress, result, [&](const Interpretation& I, bool valuation) {
+				if (valuation) model = I;
+				return not valuation;
+			});
+
+			if (result.complete()) result.value = std::move(model);
+		});
+	}
+
+	Query<std::size_t> count_satisfying_async(const Formula& formula, QueryOptions options) {
+		return launch<std::size_t>(formula, options, [](const Formula& formula, const QueryOptions& options, QueryProgress& progress, QueryResult<std::size_t>& result) {
+			sweep(formula, options, progress, result, [](const Interpretation&, bool) { return true; });
+
+			if (result.complete()) result.value = result.satisfied;
+		});
+	}
+
+	Query<bool> is_tautology_async(const Formula& formula, QueryOptions options) {
+		return launch<bool>(formula, options, [](const Formula& formula, const QueryOptions& options, QueryProgress& progress, QueryResult<bool>& result) {
+			/* a single falsifying interpretation settles it */
+			sweep(formula, options, progress, result, [](const Interpretation&, bool valuation) { return valuation; });
+
+			if (result.complete()) result.value = result.satisfied == result.evaluated;
+		});
+	}
+
+	Query<std::string> tabulate_async(const Formula& formula, QueryOptions options) {
+		return launch<std::string>(formula, options, [](const Formula& formula, const QueryOptions& options, QueryProgress& progress, QueryResult<std::string>& result) {
+			std::stringstream repr;
+			sweep(formula, options, progress, result, [&](const Interpretation& I, bool valuation) {
+				repr << I << ": " << valuation << "\n";
+				return true;
+			});
+
+			if (result.complete()) result.value = repr.str();
+		});
+	}
+}
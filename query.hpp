@@ -0,0 +1,142 @@
+#pragma once
+
+#include "formula.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace logic {
+	/* a flag shared between copies, set by the caller to stop the queries holding it */
+	class CancellationToken {
+		std::shared_ptr<std::atomic<bool>> flag = std::make_shared<std::atomic<bool>>(false);
+
+	public:
+		void cancel() const;
+		bool cancelled() const;
+	};
+
+	/* limits on an asynchronous query, it stops at whichever is reached first */
+	struct QueryOptions {
+		std::optional<std::chrono::steady_clock::time_point> deadline;
+		/*
+		 * maximum number of interpretations to evaluate - the budget counts rows of
+		 * the brute force sweep, not solver work such as conflicts or propagations
+		 */
+		std::optional<std::uint64_t> budget;
+		CancellationToken token;
+	};
+
+	enum class QueryStatus {
+		complete,
+		timeout,
+		budget_exhausted,
+		cancelled,
+	};
+
+	/* the answer to a query, or what is known so far if it was stopped */
+	template<typename T>
+	struct QueryResult {
+		QueryStatus status = QueryStatus::complete;
+		/* empty unless the query is complete */
+		std::optional<T> value;
+
+		/* interpretations evaluated, and how many of them satisfied the formula */
+		std::uint64_t evaluated = 0;
+		std::uint64_t satisfied = 0;
+		/* the last interpretation evaluated */
+		std::optional<Interpretation> last;
+
+		bool complete() const {
+			return status == QueryStatus::complete;
+		}
+	};
+
+	/* state shared between a running query and its handle */
+	struct QueryProgress {
+		std::atomic<std::uint64_t> evaluated = 0;
+		/* the number of interpretations of the formula */
+		long double total = 1;
+		/* set by the handle to stop this query alone */
+		std::atomic<bool> cancelled = false;
+	};
+
+	/*
+	 * a handle on a query running in the background
+	 *
+	 * Destroying a handle, or assigning over it, before the query has finished
+	 * cancels the query and waits for it to stop - which it does after the
+	 * interpretation it is evaluating - so dropping an unfinished query never
+	 * blocks for the rest of the sweep.
+	 */
+	template<typename T>
+	class Query {
+		std::shared_ptr<QueryProgress> state;
+		std::future<QueryResult<T>> result;
+
+		void abandon() {
+			if (result.valid()) state->cancelled.store(true, std::memory_order_relaxed);
+		}
+
+	public:
+		Query(std::shared_ptr<QueryProgress> _state, std::future<QueryResult<T>> _result)
+			: state(std::move(_state)), result(std::move(_result)) { }
+
+		Query(Query&&) = default;
+
+		Query& operator=(Query&& other) {
+			if (this != &other) {
+				abandon();
+				state = std::move(other.state);
+				result = std::move(other.result);
+			}
+
+			return *this;
+		}
+
+		~Query() {
+			abandon();
+		}
+
+		/* fraction of the interpretations evaluated so far */
+		double progress() const {
+			return state->evaluated.load(std::memory_order_relaxed) / state->total;
+		}
+
+		/* stop this query, leaving any others sharing its CancellationToken running */
+		void cancel() const {
+			state->cancelled.store(true, std::memory_order_relaxed);
+		}
+
+		bool ready() const {
+			return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+
+		template<typename Rep, typename Period>
+		bool wait_for(const std::chrono::duration<Rep, Period>& timeout) const {
+			return result.wait_for(timeout) == std::future_status::ready;
+		}
+
+		/* blocks until the query finishes, can only be called once */
+		QueryResult<T> get() {
+			return result.get();
+		}
+	};
+
+	/*
+	 * asynchronous versions of the Formula queries
+	 *
+	 * Each one sweeps the interpretations in the same order as the blocking version on
+	 * a thread of its own, checking its limits after every interpretation. Answers
+	 * found before the sweep ends - a model, or an interpretation falsifying a
+	 * tautology - complete the query early.
+	 */
+	Query<std::optional<Interpretation>> satisfy_async(const Formula&, QueryOptions = {});
+	Query<std::size_t> count_satisfying_async(const Formula&, QueryOptions = {});
+	Query<bool> is_tautology_async(const Formula&, QueryOptions = {});
+	Query<std::string> tabulate_async(const Formula&, QueryOptions = {});
+}
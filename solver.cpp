@@ -0,0 +1,721 @@
+#include "solver.hpp"
+#include "portfolio.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace logic {
+	namespace {
+		/* the reluctant doubling sequence 1, 1, 2, 1, 1, 2, 4, 1, ... scaled by base */
+		std::size_t luby(std::size_t base, std::size_t index) {
+			std::size_t size = 1, sequence = 0;
+			while (size < index + 1) {
+				sequence++;
+				size = 2 * size + 1;
+			}
+
+			while (size - 1 != index) {
+				size = (size - 1) >> 1;
+				sequence--;
+				index %= size;
+			}
+
+			return base << sequence;
+		}
+
+		/* the number of conflicts before restart number index */
+		std::size_t restart_limit(RestartPolicy policy, std::size_t index) {
+			if (policy == RestartPolicy::luby) return luby(100, index);
+
+			return std::min(100 * std::pow(1.5, index), 1e15);
+		}
+	}
+
+	Solver::Solver(SolverOptions _options) : options(_options), random(_options.seed) { }
+
+	Solver::Solver(const Formula& formula, SolverOptions _options) : Solver(_options) {
+		add(formula);
+	}
+
+	void Solver::add(const Formula& formula) {
+		problem.add(formula);
+		grow_to(problem.num_variables());
+
+		auto added = problem.release_clauses();
+		for (const auto & clause : added) {
+			for (auto literal : clause) check_not_eliminated(literal.variable());
+		}
+
+		for (auto & clause : added) {
+			/* clauses added inside a scope are switched off by its selector */
+			if (not scopes.empty()) clause.emplace_back(scopes.back(), true);
+			add_clause(std::move(clause));
+		}
+	}
+
+	void Solver::declare(const std::string& name) {
+		problem.variable(name);
+		grow_to(problem.num_variables());
+	}
+
+	void Solver::freeze(const std::string& name) {
+		auto variable = problem.variable(name);
+		grow_to(problem.num_variables());
+		check_not_eliminated(variable);
+
+		frozen[variable] = true;
+	}
+
+	void Solver::preprocess() {
+		if (not ok) return;
+		backtrack(0);
+
+		Preprocessor preprocessor(problem.num_variables(), reconstruction);
+		for (std::uint32_t variable = 0; variable < problem.num_variables(); variable++) {
+			if (frozen[variable] || eliminated[variable]) preprocessor.freeze(variable);
+		}
+		for (auto selector : scopes) {
+			preprocessor.freeze(selector);
+		}
+
+		/* units at level 0, and the problem clauses - learnt clauses are dropped */
+		for (auto literal : trail) {
+			preprocessor.add_clause({ literal });
+		}
+		for (auto & clause : clauses) {
+			if (not clause.learnt && not clause.deleted) preprocessor.add_clause(std::move(clause.literals));
+		}
+		ok = preprocessor.run();
+
+		for (std::uint32_t variable = 0; variable < problem.num_variables(); variable++) {
+			if (preprocessor.is_eliminated(variable)) eliminated[variable] = true;
+
+			assignment[variable] = -1;
+			reason[variable] = no_reason;
+			if (heap_position[variable] < 0) heap_insert(variable);
+		}
+		for (auto & watchers : watches) watchers.clear();
+		clauses.clear();
+		num_learnts = 0;
+		max_learnts = 0;
+		learnts_growth_interval = 100;
+		learnts_growth_at = num_conflicts + learnts_growth_interval;
+		trail.clear();
+		propagation_head = 0;
+
+		for (auto & clause : preprocessor.release_clauses()) {
+			add_clause(std::move(clause));
+		}
+	}
+
+	void Solver::push() {
+		auto selector = problem.new_variable();
+		grow_to(problem.num_variables());
+		scopes.push_back(selector);
+	}
+
+	void Solver::pop() {
+		if (scopes.empty()) {
+			throw std::out_of_range("pop called without a matching push.");
+		}
+
+		/* permanently disable the scope - every clause depending on it is now satisfied */
+		auto selector = scopes.back();
+		scopes.pop_back();
+		add_clause({ Literal(selector, true) });
+		simplify();
+	}
+
+	std::optional<Interpretation> Solver::solve(const Interpretation& assumed) {
+		conflict.clear();
+		if (not ok) return std::nullopt;
+
+		assumptions.clear();
+		for (auto selector : scopes) {
+			assumptions.emplace_back(selector);
+		}
+		for (const auto & [name, valuation] : assumed) {
+			assumptions.emplace_back(problem.variable(name), not valuation);
+		}
+		grow_to(problem.num_variables());
+		for (auto assumption : assumptions) {
+			check_not_eliminated(assumption.variable());
+		}
+
+		if (max_learnts == 0) {
+			max_learnts = std::max<double>(clauses.size() / 3.0, 1000);
+		}
+
+		stopped = false;
+		std::optional<bool> status;
+		for (std::size_t restarts = 0; not status.has_value(); restarts++) {
+			/* restarts are at level 0, where clauses can be added and the solver left */
+			if (should_stop()) {
+				stopped = true;
+				return std::nullopt;
+			}
+
+			import_shared();
+			if (not ok) {
+				status = false;
+				break;
+			}
+
+			status = search(restart_limit(options.restarts, restarts));
+		}
+
+		if (not *status) {
+			backtrack(0);
+			return std::nullopt;
+		}
+
+		/* eliminated variables are unassigned, reconstruction gives them a value */
+		std::vector<bool> values(assignment.size());
+		for (std::uint32_t variable = 0; variable < assignment.size(); variable++) {
+			values[variable] = assignment[variable] == 1;
+		}
+		reconstruction.extend(values);
+
+		Interpretation model;
+		for (std::uint32_t variable = 0; variable < assignment.size(); variable++) {
+			if (not problem.is_auxiliary(variable)) {
+				model[problem.name(variable)] = values[variable];
+			}
+		}
+
+		backtrack(0);
+		return model;
+	}
+
+	Interpretation Solver::failed_assumptions() const {
+		Interpretation failed;
+		for (const auto & literal : conflict) {
+			if (not problem.is_auxiliary(literal.variable())) {
+				failed[problem.name(literal.variable())] = not literal.negated();
+			}
+		}
+
+		return failed;
+	}
+
+	bool Solver::interrupted() const {
+		return stopped;
+	}
+
+	std::size_t Solver::conflicts() const {
+		return num_conflicts;
+	}
+
+	void Solver::grow_to(std::size_t num_variables) {
+		auto old_size = assignment.size();
+		if (num_variables <= old_size) return;
+
+		assignment.resize(num_variables, -1);
+		level.resize(num_variables, 0);
+		reason.resize(num_variables, no_reason);
+		saved_phase.resize(num_variables, options.initial_phase);
+		frozen.resize(num_variables, false);
+		eliminated.resize(num_variables, false);
+		seen.resize(num_variables, false);
+		activity.resize(num_variables, 0);
+		heap_position.resize(num_variables, -1);
+		watches.resize(2 * num_variables);
+
+		for (auto variable = old_size; variable < num_variables; variable++) {
+			/* a seed breaks ties between fresh variables differently */
+			if (options.seed != 0) activity[variable] = std::uniform_real_distribution<double>(0, 1e-5)(random);
+			heap_insert(variable);
+		}
+	}
+
+	void Solver::check_not_eliminated(std::uint32_t variable) const {
+		if (eliminated[variable]) {
+			throw std::logic_error("Variable " + problem.name(variable) + " was eliminated by preprocessing, freeze it first.");
+		}
+	}
+
+	/* add a problem clause, only called at decision level 0 */
+	void Solver::add_clause(std::vector<Literal> literals) {
+		if (not ok) return;
+
+		std::sort(literals.begin(), literals.end(), [](Literal a, Literal b) { return a.code < b.code; });
+
+		/* drop duplicates and literals already false, skip tautologies and satisfied clauses */
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < literals.size(); i++) {
+			auto literal = literals[i];
+			if (value(literal) == 1 || (kept > 0 && literals[kept - 1] == ~literal)) return;
+			if (value(literal) == 0 || (kept > 0 && literals[kept - 1] == literal)) continue;
+			literals[kept++] = literal;
+		}
+		literals.resize(kept);
+
+		if (literals.empty()) {
+			ok = false;
+		} else if (literals.size() == 1) {
+			enqueue(literals.front(), no_reason);
+			ok = propagate() == no_reason;
+		} else {
+			attach(std::move(literals), false, 0);
+		}
+	}
+
+	std::uint32_t Solver::attach(std::vector<Literal> literals, bool learnt, std::uint32_t lbd) {
+		std::uint32_t index = clauses.size();
+
+		watches[literals[0].code].push_back({ index, literals[1] });
+		watches[literals[1].code].push_back({ index, literals[0] });
+
+		if (learnt) num_learnts++;
+		clauses.push_back({ std::move(literals), learnt, false, lbd, 0 });
+
+		return index;
+	}
+
+	/* 1 if the literal is true, 0 if it is false and -1 if it is unassigned */
+	std::int8_t Solver::value(Literal literal) const {
+		auto valuation = assignment[literal.variable()];
+		if (valuation < 0) return -1;
+
+		return valuation != literal.negated();
+	}
+
+	std::uint32_t Solver::decision_level() const {
+		return trail_limits.size();
+	}
+
+	void Solver::enqueue(Literal literal, std::uint32_t cause) {
+		auto variable = literal.variable();
+		assignment[variable] = not literal.negated();
+		level[variable] = decision_level();
+		reason[variable] = cause;
+		trail.push_back(literal);
+	}
+
+	/* unit propagation using two watched literals, returns the conflicting clause if there is one */
+	std::uint32_t Solver::propagate() {
+		std::uint32_t conflicting = no_reason;
+
+		while (propagation_head < trail.size() && conflicting == no_reason) {
+			auto false_literal = ~trail[propagation_head++];
+			auto& watchers = watches[false_literal.code];
+
+			std::size_t i = 0, j = 0;
+			while (i < watchers.size()) {
+				auto watch = watchers[i++];
+				if (value(watch.blocker) == 1) {
+					watchers[j++] = watch;
+					continue;
+				}
+
+				auto& clause = clauses[watch.clause];
+				if (clause.deleted) continue;
+
+				/* make sure the false literal is the second one */
+				auto& literals = clause.literals;
+				if (literals[0] == false_literal) std::swap(literals[0], literals[1]);
+
+				auto first = literals[0];
+				if (first != watch.blocker && value(first) == 1) {
+					watchers[j++] = { watch.clause, first };
+					continue;
+				}
+
+				/* look for a new literal to watch */
+				bool moved = false;
+				for (std::size_t k = 2; k < literals.size(); k++) {
+					if (value(literals[k]) != 0) {
+						std::swap(literals[1], literals[k]);
+						watches[literals[1].code].push_back({ watch.clause, first });
+						moved = true;
+						break;
+					}
+				}
+				if (moved) continue;
+
+				/* the clause is unit or conflicting */
+				watchers[j++] = watch;
+				if (value(first) == 0) {
+					conflicting = watch.clause;
+					while (i < watchers.size()) watchers[j++] = watchers[i++];
+				} else {
+					enqueue(first, watch.clause);
+				}
+			}
+			watchers.resize(j);
+		}
+
+		return conflicting;
+	}
+
+	void Solver::backtrack(std::uint32_t target) {
+		if (decision_level() <= target) return;
+
+		for (auto i = trail.size(); i-- > trail_limits[target];) {
+			auto variable = trail[i].variable();
+			saved_phase[variable] = assignment[variable] == 1;
+			assignment[variable] = -1;
+			reason[variable] = no_reason;
+			if (heap_position[variable] < 0) heap_insert(variable);
+		}
+
+		trail.resize(trail_limits[target]);
+		trail_limits.resize(target);
+		propagation_head = trail.size();
+	}
+
+	/* first unique implication point conflict analysis */
+	void Solver::analyze(std::uint32_t conflicting, std::vector<Literal>& learnt, std::uint32_t& backtrack_level, std::uint32_t& lbd) {
+		learnt.assign(1, Literal());
+
+		std::size_t paths = 0;
+		std::optional<Literal> pivot;
+		auto index = trail.size();
+
+		do {
+			auto& clause = clauses[conflicting];
+			if (clause.learnt) bump_clause(clause);
+
+			for (std::size_t j = pivot.has_value() ? 1 : 0; j < clause.literals.size(); j++) {
+				auto literal = clause.literals[j];
+				auto variable = literal.variable();
+				if (seen[variable] || level[variable] == 0) continue;
+
+				bump_variable(variable);
+				seen[variable] = true;
+				if (level[variable] >= decision_level()) {
+					paths++;
+				} else {
+					learnt.push_back(literal);
+				}
+			}
+
+			/* walk back to the next literal involved in the conflict */
+			while (not seen[trail[--index].variable()]);
+			pivot = trail[index];
+			conflicting = reason[pivot->variable()];
+			seen[pivot->variable()] = false;
+			paths--;
+		} while (paths > 0);
+
+		learnt[0] = ~*pivot;
+
+		/* drop literals implied by the rest of the clause */
+		std::vector<Literal> analyzed(learnt.begin() + 1, learnt.end());
+		learnt.erase(
+			std::remove_if(learnt.begin() + 1, learnt.end(), [&](Literal literal) { return redundant(literal); }),
+			learnt.end()
+		);
+		for (const auto & literal : analyzed) seen[literal.variable()] = false;
+
+		/* put the literal from the highest remaining level second, it is watched */
+		backtrack_level = 0;
+		if (learnt.size() > 1) {
+			std::size_t highest = 1;
+			for (std::size_t i = 2; i < learnt.size(); i++) {
+				if (level[learnt[i].variable()] > level[learnt[highest].variable()]) highest = i;
+			}
+			std::swap(learnt[1], learnt[highest]);
+			backtrack_level = level[learnt[1].variable()];
+		}
+
+		std::vector<std::uint32_t> levels;
+		for (const auto & literal : learnt) levels.push_back(level[literal.variable()]);
+		std::sort(levels.begin(), levels.end());
+		lbd = std::unique(levels.begin(), levels.end()) - levels.begin();
+	}
+
+	/* a literal is redundant if its reason only contains literals already in the learnt clause */
+	bool Solver::redundant(Literal literal) const {
+		auto cause = reason[literal.variable()];
+		if (cause == no_reason) return false;
+
+		const auto & literals = clauses[cause].literals;
+		return std::all_of(literals.begin() + 1, literals.end(), [&](Literal other) {
+			return seen[other.variable()] || level[other.variable()] == 0;
+		});
+	}
+
+	/* collect the assumptions which lead to the literal being false */
+	void Solver::analyze_final(Literal failed) {
+		conflict.assign(1, failed);
+		if (decision_level() == 0) return;
+
+		seen[failed.variable()] = true;
+		for (auto i = trail.size(); i-- > trail_limits[0];) {
+			auto variable = trail[i].variable();
+			if (not seen[variable]) continue;
+
+			if (reason[variable] == no_reason) {
+				/* decisions below the assumption levels are the assumptions themselves */
+				conflict.push_back(trail[i]);
+			} else {
+				const auto & literals = clauses[reason[variable]].literals;
+				for (std::size_t j = 1; j < literals.size(); j++) {
+					if (level[literals[j].variable()] > 0) seen[literals[j].variable()] = true;
+				}
+			}
+			seen[variable] = false;
+		}
+		seen[failed.variable()] = false;
+	}
+
+	void Solver::bump_variable(std::uint32_t variable) {
+		if ((activity[variable] += variable_increment) > 1e100) {
+			for (auto & value : activity) value *= 1e-100;
+			variable_increment *= 1e-100;
+		}
+
+		if (heap_position[variable] >= 0) heap_up(heap_position[variable]);
+	}
+
+	void Solver::bump_clause(StoredClause& clause) {
+		if ((clause.activity += clause_increment) > 1e20) {
+			for (auto & stored : clauses) {
+				if (stored.learnt) stored.activity *= 1e-20;
+			}
+			clause_increment *= 1e-20;
+		}
+	}
+
+	/* throw away the less useful half of the learnt clauses */
+	void Solver::reduce_learnts() {
+		std::vector<std::uint32_t> candidates;
+		for (std::uint32_t index = 0; index < clauses.size(); index++) {
+			const auto & clause = clauses[index];
+			if (not clause.learnt || clause.deleted || clause.literals.size() <= 2 || clause.lbd <= 2) continue;
+
+			/* keep clauses which are the reason for an assignment */
+			auto first = clause.literals[0];
+			if (reason[first.variable()] == index && value(first) == 1) continue;
+
+			candidates.push_back(index);
+		}
+
+		std::sort(candidates.begin(), candidates.end(), [&](std::uint32_t a, std::uint32_t b) {
+			if (clauses[a].lbd != clauses[b].lbd) return clauses[a].lbd > clauses[b].lbd;
+			return clauses[a].activity < clauses[b].activity;
+		});
+
+		for (std::size_t i = 0; i < candidates.size() / 2; i++) {
+			auto& clause = clauses[candidates[i]];
+			clause.deleted = true;
+			clause.literals = {};
+			num_learnts--;
+		}
+
+		collect_garbage();
+	}
+
+	/* remove clauses satisfied at decision level 0 */
+	void Solver::simplify() {
+		if (not ok || decision_level() != 0) return;
+
+		for (auto & clause : clauses) {
+			if (clause.deleted) continue;
+
+			bool satisfied = std::any_of(clause.literals.begin(), clause.literals.end(), [&](Literal literal) {
+				return value(literal) == 1;
+			});
+			if (not satisfied) continue;
+
+			if (clause.learnt) num_learnts--;
+			clause.deleted = true;
+			clause.literals = {};
+		}
+
+		collect_garbage();
+	}
+
+	/* drop deleted clauses from the clause list, renumbering the reasons and watches referring to the rest */
+	void Solver::collect_garbage() {
+		std::vector<std::uint32_t> moved(clauses.size(), no_reason);
+		std::size_t kept = 0;
+		for (std::size_t index = 0; index < clauses.size(); index++) {
+			if (clauses[index].deleted) continue;
+
+			moved[index] = kept;
+			if (kept != index) clauses[kept] = std::move(clauses[index]);
+			kept++;
+		}
+		clauses.erase(clauses.begin() + kept, clauses.end());
+
+		/* reasons of level 0 assignments can be deleted by simplify, they aren't needed again */
+		for (auto literal : trail) {
+			auto& cause = reason[literal.variable()];
+			if (cause != no_reason) cause = moved[cause];
+		}
+
+		for (auto & watchers : watches) {
+			std::size_t j = 0;
+			for (auto watch : watchers) {
+				if (moved[watch.clause] == no_reason) continue;
+
+				watch.clause = moved[watch.clause];
+				watchers[j++] = watch;
+			}
+			watchers.resize(j);
+		}
+	}
+
+	void Solver::heap_insert(std::uint32_t variable) {
+		heap_position[variable] = heap.size();
+		heap.push_back(variable);
+		heap_up(heap.size() - 1);
+	}
+
+	std::uint32_t Solver::heap_pop() {
+		auto top = heap.front();
+		heap.front() = heap.back();
+		heap_position[heap.front()] = 0;
+		heap.pop_back();
+		heap_position[top] = -1;
+
+		if (not heap.empty()) heap_down(0);
+		return top;
+	}
+
+	void Solver::heap_up(std::size_t position) {
+		auto variable = heap[position];
+		while (position > 0) {
+			auto parent = (position - 1) / 2;
+			if (activity[heap[parent]] >= activity[variable]) break;
+
+			heap[position] = heap[parent];
+			heap_position[heap[position]] = position;
+			position = parent;
+		}
+
+		heap[position] = variable;
+		heap_position[variable] = position;
+	}
+
+	void Solver::heap_down(std::size_t position) {
+		auto variable = heap[position];
+		while (2 * position + 1 < heap.size()) {
+			auto child = 2 * position + 1;
+			if (child + 1 < heap.size() && activity[heap[child + 1]] > activity[heap[child]]) child++;
+			if (activity[heap[child]] <= activity[variable]) break;
+
+			heap[position] = heap[child];
+			heap_position[heap[position]] = position;
+			position = child;
+		}
+
+		heap[position] = variable;
+		heap_position[variable] = position;
+	}
+
+	/* the unassigned variable with the highest activity, set to its last value */
+	std::optional<Literal> Solver::pick_branch() {
+		if (options.random_frequency > 0 && not heap.empty()
+			&& std::uniform_real_distribution<double>(0, 1)(random) < options.random_frequency) {
+			auto variable = heap[random() % heap.size()];
+			if (assignment[variable] < 0 && not eliminated[variable]) {
+				return Literal(variable, not saved_phase[variable]);
+			}
+		}
+
+		while (not heap.empty()) {
+			auto variable = heap_pop();
+			if (assignment[variable] < 0 && not eliminated[variable]) {
+				return Literal(variable, not saved_phase[variable]);
+			}
+		}
+
+		return std::nullopt;
+	}
+
+	/* search until a result is found or max_conflicts is reached - in which case nothing is returned */
+	std::optional<bool> Solver::search(std::size_t max_conflicts) {
+		std::size_t conflicts_here = 0;
+		std::vector<Literal> learnt;
+
+		while (true) {
+			auto conflicting = propagate();
+			if (conflicting != no_reason) {
+				num_conflicts++;
+				conflicts_here++;
+
+				if (decision_level() == 0) {
+					ok = false;
+					return false;
+				}
+
+				std::uint32_t backtrack_level, lbd;
+				analyze(conflicting, learnt, backtrack_level, lbd);
+				backtrack(backtrack_level);
+
+				/* short clauses are worth passing on to the other solvers */
+				if (options.exchange != nullptr && scopes.empty() && learnt.size() <= 2) {
+					options.exchange->publish(learnt);
+				}
+
+				if (learnt.size() == 1) {
+					enqueue(learnt[0], no_reason);
+				} else {
+					auto index = attach(learnt, true, lbd);
+					bump_clause(clauses[index]);
+					enqueue(learnt[0], index);
+				}
+
+				variable_increment /= options.variable_decay;
+				clause_increment /= 0.999;
+
+				/* allow more learnt clauses at geometrically spaced conflict counts */
+				if (num_conflicts >= learnts_growth_at) {
+					max_learnts *= 1.1;
+					learnts_growth_interval *= 1.5;
+					learnts_growth_at += learnts_growth_interval;
+				}
+				continue;
+			}
+
+			if (conflicts_here >= max_conflicts || should_stop()) {
+				backtrack(0);
+				return std::nullopt;
+			}
+
+			if (num_learnts >= max_learnts + trail.size()) reduce_learnts();
+
+			/* assumptions are decided first, one per decision level */
+			std::optional<Literal> next;
+			while (decision_level() < assumptions.size()) {
+				auto assumption = assumptions[decision_level()];
+				if (value(assumption) == 1) {
+					trail_limits.push_back(trail.size());
+				} else if (value(assumption) == 0) {
+					analyze_final(assumption);
+					return false;
+				} else {
+					next = assumption;
+					break;
+				}
+			}
+
+			if (not next.has_value()) {
+				next = pick_branch();
+				if (not next.has_value()) return true;
+			}
+
+			trail_limits.push_back(trail.size());
+			enqueue(*next, no_reason);
+		}
+	}
+
+	bool Solver::should_stop() const {
+		return options.stop != nullptr && options.stop->load(std::memory_order_relaxed);
+	}
+
+	/* add the clauses other solvers have published since the last call, at level 0 */
+	void Solver::import_shared() {
+		if (options.exchange == nullptr || not scopes.empty()) return;
+
+		for (auto & clause : options.exchange->collect(exchange_cursor)) {
+			bool known = std::all_of(clause.begin(), clause.end(), [&](Literal literal) {
+				return literal.variable() < assignment.size() && not eliminated[literal.variable()];
+			});
+			if (known) add_clause(std::move(clause));
+		}
+	}
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "cnf.hpp"
+#include "formula.hpp"
+#include "preprocess.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace logic {
+	class ClauseExchange;
+
+	enum class RestartPolicy {
+		/* the Luby sequence 1, 1, 2, 1, 1, 2, 4, ... times 100 conflicts */
+		luby,
+		/* 100 conflicts, growing by half each restart */
+		geometric,
+	};
+
+	/* search parameters, varied between the engines of a portfolio */
+	struct SolverOptions {
+		/* seeds the initial variable order and random decisions, 0 keeps the default order */
+		std::uint64_t seed = 0;
+		/* fraction of decisions made on a random variable */
+		double random_frequency = 0;
+		/* how quickly the activity of variables not in recent conflicts fades */
+		double variable_decay = 0.95;
+		RestartPolicy restarts = RestartPolicy::luby;
+		/* valuation tried first for a variable never assigned before */
+		bool initial_phase = false;
+
+		/* solve gives up as soon as this is set */
+		const std::atomic<bool>* stop = nullptr;
+		/* short learnt clauses are published to and collected from here, every solver
+		 * sharing an exchange has to be built from the same formulas */
+		ClauseExchange* exchange = nullptr;
+	};
+
+	/*
+	 * an incremental CDCL satisfiability solver
+	 *
+	 * Formulas are loaded once and then queried repeatedly under different assumptions.
+	 * Learned clauses and variable activity are kept between calls to solve,
+	 * so related queries are much cheaper than solving each one from scratch.
+	 *
+	 * push / pop open and close a scope - formulas added inside a scope are
+	 * retracted again when it is popped.
+	 *
+	 * preprocess simplifies the clauses loaded so far, eliminating variables
+	 * where that makes the problem smaller. Models still cover the eliminated
+	 * variables, but they can't be used by later formulas or assumptions
+	 * unless they were frozen first.
+	 *
+	 * SolverOptions change the search strategy and let another thread stop a
+	 * call to solve, in which case interrupted tells it apart from unsatisfiability.
+	 */
+	class Solver {
+		/* sentinel for "no reason clause" */
+		static constexpr std::uint32_t no_reason = UINT32_MAX;
+
+		struct StoredClause {
+			std::vector<Literal> literals;
+			bool learnt;
+			bool deleted;
+			/* number of distinct decision levels in a learnt clause */
+			std::uint32_t lbd;
+			double activity;
+		};
+
+		struct Watch {
+			std::uint32_t clause;
+			/* a literal of the clause, if it is true the clause doesn't need to be visited */
+			Literal blocker;
+		};
+
+		/* clause form of everything added, used for the variable names */
+		CNF problem;
+
+		std::vector<StoredClause> clauses;
+		/* indexed by literal code, the clauses watching that literal */
+		std::vector<std::vector<Watch>> watches;
+		std::size_t num_learnts = 0;
+
+		/* per variable state, assignment is -1 when unassigned */
+		std::vector<std::int8_t> assignment;
+		std::vector<std::uint32_t> level;
+		std::vector<std::uint32_t> reason;
+		std::vector<bool> saved_phase;
+		std::vector<bool> seen;
+
+		/* assigned literals in order, and the start of each decision level within it */
+		std::vector<Literal> trail;
+		std::vector<std::size_t> trail_limits;
+		std::size_t propagation_head = 0;
+
+		/* VSIDS - a max heap of variables ordered by activity */
+		std::vector<double> activity;
+		std::vector<std::uint32_t> heap;
+		std::vector<std::int64_t> heap_position;
+		double variable_increment = 1;
+		double clause_increment = 1;
+
+		/* selector variables for the open scopes, innermost last */
+		std::vector<std::uint32_t> scopes;
+
+		/* variable elimination done by preprocess, and the variables it has to keep */
+		std::vector<bool> frozen;
+		std::vector<bool> eliminated;
+		ReconstructionStack reconstruction;
+
+		std::vector<Literal> assumptions;
+		std::vector<Literal> conflict;
+
+		SolverOptions options;
+		std::mt19937_64 random;
+		/* position in the exchange up to which clauses have been collected */
+		std::uint64_t exchange_cursor = 0;
+
+		/* false once the clause set is unsatisfiable without any assumptions */
+		bool ok = true;
+		/* true if the last call to solve was stopped */
+		bool stopped = false;
+		/* learnt clauses kept before reducing, it grows with the number of conflicts */
+		double max_learnts = 0;
+		std::size_t learnts_growth_at = 100;
+		double learnts_growth_interval = 100;
+		std::size_t num_conflicts = 0;
+
+		void grow_to(std::size_t num_variables);
+		void check_not_eliminated(std::uint32_t) const;
+		void add_clause(std::vector<Literal>);
+		std::uint32_t attach(std::vector<Literal>, bool learnt, std::uint32_t lbd);
+
+		std::int8_t value(Literal) const;
+		std::uint32_t decision_level() const;
+		void enqueue(Literal, std::uint32_t reason);
+		std::uint32_t propagate();
+		void backtrack(std::uint32_t level);
+
+		void analyze(std::uint32_t conflict, std::vector<Literal>& learnt, std::uint32_t& backtrack_level, std::uint32_t& lbd);
+		bool redundant(Literal) const;
+		void analyze_final(Literal);
+
+		void bump_variable(std::uint32_t);
+		void bump_clause(StoredClause&);
+		void reduce_learnts();
+		void simplify();
+		void collect_garbage();
+
+		void heap_insert(std::uint32_t);
+		std::uint32_t heap_pop();
+		void heap_up(std::size_t);
+		void heap_down(std::size_t);
+
+		std::optional<Literal> pick_branch();
+		std::optional<bool> search(std::size_t max_conflicts);
+		bool should_stop() const;
+		void import_shared();
+
+	public:
+		Solver(SolverOptions = {});
+		Solver(const Formula&, SolverOptions = {});
+
+		/* conjoin a formula with the current scope */
+		void add(const Formula&);
+
+		/* make sure a variable is known, so it is assigned in every model */
+		void declare(const std::string&);
+
+		/* keep a variable through preprocessing, so it can be used in later formulas and assumptions */
+		void freeze(const std::string&);
+
+		/* simplify the clauses added so far - see Preprocessor */
+		void preprocess();
+
+		/* open / close a scope of retractable formulas */
+		void push();
+		void pop();
+
+		/*
+		 * check satisfiability with every variable in assumptions fixed to its valuation
+		 * produces a model on success - otherwise failed_assumptions gives the reason
+		 */
+		std::optional<Interpretation> solve(const Interpretation& assumptions = {});
+
+		/* after an unsatisfiable call to solve, a subset of the assumptions which can't hold together
+		 * this is empty if the formulas are unsatisfiable on their own */
+		Interpretation failed_assumptions() const;
+
+		/* true if the last call to solve gave up because of the stop flag, rather than finding no model */
+		bool interrupted() const;
+
+		std::size_t conflicts() const;
+	};
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include "formula.hpp"
+#include "truth_table.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/*
+ * formulas whose structure is fixed at compile time
+ *
+ * The same operators as Formula build a type rather than a tree, e.g.
+ *
+ *   constexpr static_formula::Variable<0> p;
+ *   constexpr static_formula::Variable<1> q;
+ *   constexpr auto expr = (p or q).implies(p and not q);
+ *
+ * Every node is an empty struct and evaluation is fully inlined, variable i reads bit i
+ * of an assignment. eval_parallel evaluates 64 assignments at once from per variable columns,
+ * and to_formula produces the equivalent runtime Formula.
+ */
+namespace logic::static_formula {
+	template<typename Derived>
+	struct Expression;
+
+	template<typename T>
+	concept IsExpression = std::is_base_of_v<Expression<T>, T>;
+
+	template<IsExpression A, IsExpression B> struct Implication;
+	template<IsExpression A, IsExpression B> struct Biimplication;
+
+	/* shared members of every node, provided through CRTP */
+	template<typename Derived>
+	struct Expression {
+		/* convenient aliases matching Formula */
+		template<IsExpression B>
+		constexpr Implication<Derived, B> implies(B) const { return {}; }
+
+		template<IsExpression B>
+		constexpr Biimplication<Derived, B> equals(B) const { return {}; }
+
+		/* the truth table of an expression of at most 6 variables, row r is bit r */
+		static constexpr std::uint64_t truth_table() {
+			static_assert(Derived::num_variables <= 6, "truth_table only covers a single word.");
+
+			std::array<std::uint64_t, 6> columns {};
+			for (std::size_t i = 0; i < 6; i++) columns[i] = TruthTable::columns[i];
+
+			auto rows = Derived::eval_parallel(columns.data());
+			if constexpr (Derived::num_variables < 6) {
+				rows &= (std::uint64_t(1) << (1 << Derived::num_variables)) - 1;
+			}
+
+			return rows;
+		}
+	};
+
+	/* variable number Index - bit Index of an assignment */
+	template<std::size_t Index>
+	struct Variable : Expression<Variable<Index>> {
+		static constexpr std::size_t num_variables = Index + 1;
+
+		static constexpr bool eval(std::uint64_t assignment) { return (assignment >> Index) & 1; }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return columns[Index]; }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return Formula::PropVar(names.at(Index).c_str());
+		}
+	};
+
+	/* ⊤ or ⊥ */
+	template<bool Value>
+	struct Constant : Expression<Constant<Value>> {
+		static constexpr std::size_t num_variables = 0;
+
+		static constexpr bool eval(std::uint64_t) { return Value; }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t*) { return Value ? ~std::uint64_t(0) : 0; }
+
+		static Formula to_formula(const std::vector<std::string>&) {
+			return Value ? Formula::Tautology() : Formula::Contradiction();
+		}
+	};
+
+	using Tautology = Constant<true>;
+	using Contradiction = Constant<false>;
+
+	template<IsExpression A>
+	struct Negation : Expression<Negation<A>> {
+		static constexpr std::size_t num_variables = A::num_variables;
+
+		static constexpr bool eval(std::uint64_t assignment) { return not A::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return ~A::eval_parallel(columns); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return not A::to_formula(names);
+		}
+	};
+
+	template<IsExpression A, IsExpression B>
+	struct Conjunction : Expression<Conjunction<A, B>> {
+		static constexpr std::size_t num_variables = std::max(A::num_variables, B::num_variables);
+
+		static constexpr bool eval(std::uint64_t assignment) { return A::eval(assignment) and B::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return A::eval_parallel(columns) & B::eval_parallel(columns); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return A::to_formula(names) and B::to_formula(names);
+		}
+	};
+
+	template<IsExpression A, IsExpression B>
+	struct Disjunction : Expression<Disjunction<A, B>> {
+		static constexpr std::size_t num_variables = std::max(A::num_variables, B::num_variables);
+
+		static constexpr bool eval(std::uint64_t assignment) { return A::eval(assignment) or B::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return A::eval_parallel(columns) | B::eval_parallel(columns); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return A::to_formula(names) or B::to_formula(names);
+		}
+	};
+
+	template<IsExpression A, IsExpression B>
+	struct Implication : Expression<Implication<A, B>> {
+		static constexpr std::size_t num_variables = std::max(A::num_variables, B::num_variables);
+
+		static constexpr bool eval(std::uint64_t assignment) { return not A::eval(assignment) or B::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return ~A::eval_parallel(columns) | B::eval_parallel(columns); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return A::to_formula(names).implies(B::to_formula(names));
+		}
+	};
+
+	template<IsExpression A, IsExpression B>
+	struct Biimplication : Expression<Biimplication<A, B>> {
+		static constexpr std::size_t num_variables = std::max(A::num_variables, B::num_variables);
+
+		static constexpr bool eval(std::uint64_t assignment) { return A::eval(assignment) == B::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return ~(A::eval_parallel(columns) ^ B::eval_parallel(columns)); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return A::to_formula(names).equals(B::to_formula(names));
+		}
+	};
+
+	template<IsExpression A, IsExpression B>
+	struct ExclusiveOr : Expression<ExclusiveOr<A, B>> {
+		static constexpr std::size_t num_variables = std::max(A::num_variables, B::num_variables);
+
+		static constexpr bool eval(std::uint64_t assignment) { return A::eval(assignment) != B::eval(assignment); }
+		static constexpr std::uint64_t eval_parallel(const std::uint64_t* columns) { return A::eval_parallel(columns) ^ B::eval_parallel(columns); }
+
+		static Formula to_formula(const std::vector<std::string>& names) {
+			return A::to_formula(names) ^ B::to_formula(names);
+		}
+	};
+
+	/* construction operator overloads, matching Formula */
+	template<IsExpression A>
+	constexpr Negation<A> operator!(A) { return {}; }
+
+	template<IsExpression A, IsExpression B>
+	constexpr Conjunction<A, B> operator&&(A, B) { return {}; }
+
+	template<IsExpression A, IsExpression B>
+	constexpr Disjunction<A, B> operator||(A, B) { return {}; }
+
+	template<IsExpression A, IsExpression B>
+	constexpr Implication<A, B> operator>>(A, B) { return {}; }
+
+	template<IsExpression A, IsExpression B>
+	constexpr Biimplication<A, B> operator==(A, B) { return {}; }
+
+	/* composite construction operators */
+	template<IsExpression A, IsExpression B>
+	constexpr ExclusiveOr<A, B> operator^(A, B) { return {}; }
+
+	template<IsExpression A, IsExpression B>
+	constexpr ExclusiveOr<A, B> operator!=(A, B) { return {}; }
+}
@@ -0,0 +1,376 @@
+#include "truth_table.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <stdexcept>
+
+namespace logic {
+	namespace {
+		/* postfix program the formula tree is flattened into before evaluation */
+		enum class Operation : std::uint8_t {
+			variable,
+			constant,
+			negation,
+			conjunction,
+			disjunction,
+			implication,
+			biimplication,
+		};
+
+		struct Instruction {
+			Operation operation;
+			/* the variable's position for variable, the value for constant */
+			std::size_t operand;
+		};
+
+		/* number of words evaluated together by each instruction */
+		constexpr std::size_t block_size = 64;
+
+		/* rows beyond 2^n in a single word table are kept clear */
+		std::uint64_t row_mask(std::size_t num_variables) {
+			return num_variables >= 6 ? ~std::uint64_t(0) : (std::uint64_t(1) << (1 << num_variables)) - 1;
+		}
+
+		/* lhs = lhs op rhs, a block at a time */
+		void apply(Operation operation, std::uint64_t* lhs, const std::uint64_t* rhs, std::size_t block) {
+			switch (operation) {
+				case Operation::conjunction:
+					for (std::size_t k = 0; k < block; k++) lhs[k] &= rhs[k];
+					break;
+				case Operation::disjunction:
+					for (std::size_t k = 0; k < block; k++) lhs[k] |= rhs[k];
+					break;
+				case Operation::implication:
+					for (std::size_t k = 0; k < block; k++) lhs[k] = ~lhs[k] | rhs[k];
+					break;
+				case Operation::biimplication:
+					for (std::size_t k = 0; k < block; k++) lhs[k] = ~(lhs[k] ^ rhs[k]);
+					break;
+				default:
+					break;
+			}
+		}
+
+		/* gather the 32 bits of a word whose row has bit i equal to value into the low half */
+		std::uint64_t compress(std::uint64_t word, std::size_t i, bool value) {
+			auto x = (value ? word >> (1 << i) : word) & ~TruthTable::columns[i];
+			for (auto j = i + 1; j < 6; j++) {
+				x = (x | (x >> (1 << (j - 1)))) & ~TruthTable::columns[j];
+			}
+
+			return x;
+		}
+	}
+
+	TruthTable::TruthTable(std::vector<std::string> _variables, std::vector<std::uint64_t> _rows)
+		: variables(std::move(_variables)), rows(std::move(_rows)) { }
+
+	std::size_t TruthTable::num_words(std::size_t num_variables) {
+		return num_variables <= 6 ? 1 : std::size_t(1) << (num_variables - 6);
+	}
+
+	TruthTable::TruthTable(const Formula& formula) : variables(formula.variables) {
+		if (variables.size() > max_variables) {
+			throw std::out_of_range("Formula contains too many variables to tabulate.");
+		}
+
+		/* position of each variable in the formula, by VariableTable index */
+		auto indices = formula.variable_indices();
+		std::vector<std::size_t> positions(indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1);
+		for (std::size_t position = 0; position < indices.size(); position++) {
+			positions[indices[position]] = position;
+		}
+
+		/* flatten the tree so evaluation doesn't have to chase pointers */
+		std::vector<Instruction> program;
+		std::size_t depth = 0, max_depth = 0;
+		std::function<void(const Formula&)> compile = [&](const Formula& node) {
+			if (node.atom.has_value()) {
+				if (node.atom->type == AtomType::variable) {
+					program.push_back({ Operation::variable, positions[node.atom->index] });
+				} else {
+					program.push_back({ Operation::constant, node.atom->type == AtomType::tautology });
+				}
+				max_depth = std::max(max_depth, ++depth);
+				return;
+			}
+
+			if (*node.connective == Connective::negation) {
+				compile(*node.rsf);
+				program.push_back({ Operation::negation, 0 });
+				return;
+			}
+
+			compile(*node.lsf);
+			compile(*node.rsf);
+			switch (*node.connective) {
+				case Connective::conjunction:
+					program.push_back({ Operation::conjunction, 0 });
+					break;
+				case Connective::disjunction:
+					program.push_back({ Operation::disjunction, 0 });
+					break;
+				case Connective::implication:
+					program.push_back({ Operation::implication, 0 });
+					break;
+				case Connective::biimplication:
+					program.push_back({ Operation::biimplication, 0 });
+					break;
+				case Connective::negation:
+					break;
+			}
+			depth--;
+		};
+		compile(formula);
+
+		/* run the program on a block of words at a time - 64 rows per word */
+		rows.resize(num_words(variables.size()));
+		auto block = std::min(rows.size(), block_size);
+		std::vector<std::uint64_t> stack(max_depth * block);
+
+		for (std::size_t start = 0; start < rows.size(); start += block) {
+			auto top = stack.data();
+			for (const auto & [operation, operand] : program) {
+				switch (operation) {
+					case Operation::variable:
+						if (operand < 6) {
+							std::fill(top, top + block, columns[operand]);
+						} else {
+							for (std::size_t k = 0; k < block; k++) {
+								top[k] = ((start + k) >> (operand - 6)) & 1 ? ~std::uint64_t(0) : 0;
+							}
+						}
+						top += block;
+						break;
+					case Operation::constant:
+						std::fill(top, top + block, operand ? ~std::uint64_t(0) : 0);
+						top += block;
+						break;
+					case Operation::negation:
+						std::transform(top - block, top, top - block, std::bit_not<>{});
+						break;
+					default:
+						top -= block;
+						apply(operation, top - block, top, block);
+						break;
+				}
+			}
+
+			std::copy(stack.begin(), stack.begin() + block, rows.begin() + start);
+		}
+		rows[0] &= row_mask(variables.size());
+	}
+
+	const std::vector<std::string>& TruthTable::get_variables() const {
+		return variables;
+	}
+
+	const std::vector<std::uint64_t>& TruthTable::get_rows() const {
+		return rows;
+	}
+
+	std::size_t TruthTable::num_variables() const {
+		return variables.size();
+	}
+
+	bool TruthTable::at(std::uint64_t row) const {
+		return (rows.at(row / 64) >> (row % 64)) & 1;
+	}
+
+	bool TruthTable::eval(const Interpretation& I) const {
+		std::uint64_t row = 0;
+		for (std::size_t position = 0; position < variables.size(); position++) {
+			row |= std::uint64_t(I.at(variables[position])) << position;
+		}
+
+		return at(row);
+	}
+
+	TruthTable TruthTable::extend(const std::vector<std::string>& superset) const {
+		if (superset == variables) return *this;
+
+		/* bit position[i] of a row of the extended table is bit i of the row here */
+		std::vector<std::size_t> position;
+		for (const auto & variable : variables) {
+			position.push_back(std::lower_bound(superset.begin(), superset.end(), variable) - superset.begin());
+		}
+
+		std::vector<std::uint64_t> extended(num_words(superset.size()), 0);
+		for (std::uint64_t row = 0; row < (std::uint64_t(1) << superset.size()); row++) {
+			std::uint64_t projected = 0;
+			for (std::size_t i = 0; i < position.size(); i++) {
+				projected |= ((row >> position[i]) & 1) << i;
+			}
+
+			if (at(projected)) extended[row / 64] |= std::uint64_t(1) << (row % 64);
+		}
+
+		return { superset, std::move(extended) };
+	}
+
+	TruthTable TruthTable::combine(const TruthTable& other, std::uint64_t (*operation)(std::uint64_t, std::uint64_t)) const {
+		if (variables != other.variables) {
+			std::vector<std::string> joined;
+			std::set_union(
+				variables.begin(), variables.end(),
+				other.variables.begin(), other.variables.end(),
+				std::back_inserter(joined)
+			);
+
+			if (joined.size() > max_variables) {
+				throw std::out_of_range("Truth tables contain too many variables to combine.");
+			}
+
+			return extend(joined).combine(other.extend(joined), operation);
+		}
+
+		auto combined = rows;
+		for (std::size_t word = 0; word < combined.size(); word++) {
+			combined[word] = operation(combined[word], other.rows[word]);
+		}
+		combined[0] &= row_mask(variables.size());
+
+		return { variables, std::move(combined) };
+	}
+
+	TruthTable TruthTable::operator~() const {
+		auto complement = rows;
+		for (auto & word : complement) word = ~word;
+		complement[0] &= row_mask(variables.size());
+
+		return { variables, std::move(complement) };
+	}
+
+	TruthTable TruthTable::operator&(const TruthTable& other) const {
+		return combine(other, [](std::uint64_t a, std::uint64_t b) { return a & b; });
+	}
+
+	TruthTable TruthTable::operator|(const TruthTable& other) const {
+		return combine(other, [](std::uint64_t a, std::uint64_t b) { return a | b; });
+	}
+
+	TruthTable TruthTable::operator^(const TruthTable& other) const {
+		return combine(other, [](std::uint64_t a, std::uint64_t b) { return a ^ b; });
+	}
+
+	TruthTable TruthTable::cofactor(const std::string& variable, bool value) const {
+		auto it = std::lower_bound(variables.begin(), variables.end(), variable);
+		if (it == variables.end() || *it != variable) return *this;
+
+		std::size_t i = it - variables.begin();
+		auto remaining = variables;
+		remaining.erase(remaining.begin() + i);
+
+		std::vector<std::uint64_t> cofactor(num_words(remaining.size()), 0);
+		if (i >= 6) {
+			/* whole words are selected */
+			std::size_t stride = std::size_t(1) << (i - 6), next = 0;
+			for (std::size_t word = 0; word < rows.size(); word++) {
+				if (bool(word & stride) == value) cofactor[next++] = rows[word];
+			}
+		} else if (rows.size() == 1) {
+			cofactor[0] = compress(rows[0], i, value);
+		} else {
+			/* every word gives half a word */
+			for (std::size_t word = 0; word < cofactor.size(); word++) {
+				cofactor[word] = compress(rows[2 * word], i, value) | compress(rows[2 * word + 1], i, value) << 32;
+			}
+		}
+		cofactor[0] &= row_mask(remaining.size());
+
+		return { std::move(remaining), std::move(cofactor) };
+	}
+
+	std::size_t TruthTable::count_satisfying() const {
+		std::size_t count = 0;
+		for (auto word : rows) {
+			count += std::popcount(word);
+		}
+
+		return count;
+	}
+
+	bool TruthTable::operator==(const TruthTable& other) const {
+		return variables == other.variables && rows == other.rows;
+	}
+
+	std::size_t TruthTable::hash() const {
+		std::size_t seed = variables.size();
+		for (const auto & variable : variables) {
+			seed ^= std::hash<std::string>{}(variable) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+		}
+		for (auto word : rows) {
+			seed ^= std::hash<std::uint64_t>{}(word) + 0x9e3779b97f4a7c15 + (seed << 6) + (seed >> 2);
+		}
+
+		return seed;
+	}
+
+	std::vector<std::int32_t> TruthTable::walsh_spectrum() const {
+		std::size_t size = std::size_t(1) << variables.size();
+
+		std::vector<std::int32_t> spectrum(size);
+		for (std::size_t row = 0; row < size; row++) {
+			spectrum[row] = at(row) ? -1 : 1;
+		}
+
+		for (std::size_t length = 1; length < size; length <<= 1) {
+			for (std::size_t start = 0; start < size; start += 2 * length) {
+				for (auto i = start; i < start + length; i++) {
+					auto a = spectrum[i], b = spectrum[i + length];
+					spectrum[i] = a + b;
+					spectrum[i + length] = a - b;
+				}
+			}
+		}
+
+		return spectrum;
+	}
+
+	bool TruthTable::is_balanced() const {
+		return 2 * count_satisfying() == (std::size_t(1) << variables.size());
+	}
+
+	std::size_t TruthTable::correlation_immunity() const {
+		return correlation_immunity(walsh_spectrum());
+	}
+
+	std::size_t TruthTable::nonlinearity() const {
+		return nonlinearity(walsh_spectrum());
+	}
+
+	std::size_t TruthTable::correlation_immunity(const std::vector<std::int32_t>& spectrum) {
+		/* the smallest weight of a nonzero coefficient, other than W(0) */
+		std::size_t order = std::countr_zero(spectrum.size());
+		for (std::size_t a = 1; a < spectrum.size(); a++) {
+			if (spectrum[a] != 0) order = std::min<std::size_t>(order, std::popcount(a) - 1);
+		}
+
+		return order;
+	}
+
+	std::size_t TruthTable::nonlinearity(const std::vector<std::int32_t>& spectrum) {
+		std::int64_t peak = 0;
+		for (auto coefficient : spectrum) {
+			peak = std::max<std::int64_t>(peak, std::abs(coefficient));
+		}
+
+		/* 2^(n-1) - max |W(a)| / 2 */
+		return (std::int64_t(spectrum.size()) - peak) / 2;
+	}
+
+	std::ostream& operator<<(std::ostream& os, const TruthTable& table) {
+		for (std::uint64_t row = 0; row < (std::uint64_t(1) << table.variables.size()); row++) {
+			os << '[';
+			for (std::size_t position = 0; position < table.variables.size(); position++) {
+				if (position != 0) os << ", ";
+				os << table.variables[position] << " ↦ " << ((row >> position) & 1);
+			}
+			os << "]: " << table.at(row) << "\n";
+		}
+
+		return os;
+	}
+}
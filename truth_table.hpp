@@ -0,0 +1,99 @@
+#pragma once
+
+#include "formula.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace logic {
+	/*
+	 * the truth table of a boolean function of up to 30 variables
+	 *
+	 * Row r assigns variable i the value of bit i of r, variables are sorted by name
+	 * as in Formula. Rows are packed 64 to a word so the table algebra, counting and
+	 * comparisons all work a word at a time.
+	 *
+	 * Tables over different variables can be combined, both sides are first
+	 * extended to the union of the variables.
+	 */
+	class TruthTable {
+		std::vector<std::string> variables;
+
+		/* bit r % 64 of word r / 64 is the valuation of row r */
+		std::vector<std::uint64_t> rows;
+
+		TruthTable(std::vector<std::string>, std::vector<std::uint64_t>);
+
+		/* the same function over a superset of the variables */
+		TruthTable extend(const std::vector<std::string>&) const;
+		TruthTable combine(const TruthTable&, std::uint64_t (*)(std::uint64_t, std::uint64_t)) const;
+
+	public:
+		static constexpr std::size_t max_variables = 30;
+
+		/* bit r is set if bit i of r is set - the column of variable i within a word */
+		static constexpr std::uint64_t columns[6] = {
+			0xAAAAAAAAAAAAAAAA,
+			0xCCCCCCCCCCCCCCCC,
+			0xF0F0F0F0F0F0F0F0,
+			0xFF00FF00FF00FF00,
+			0xFFFF0000FFFF0000,
+			0xFFFFFFFF00000000,
+		};
+
+		/* number of words needed for a table of n variables */
+		static std::size_t num_words(std::size_t num_variables);
+
+		TruthTable(const Formula&);
+
+		const std::vector<std::string>& get_variables() const;
+		const std::vector<std::uint64_t>& get_rows() const;
+		std::size_t num_variables() const;
+
+		bool at(std::uint64_t row) const;
+		bool eval(const Interpretation&) const;
+
+		/* word parallel table algebra */
+		TruthTable operator~() const;
+		TruthTable operator&(const TruthTable&) const;
+		TruthTable operator|(const TruthTable&) const;
+		TruthTable operator^(const TruthTable&) const;
+
+		/* the function with a variable fixed, which no longer depends on it */
+		TruthTable cofactor(const std::string& variable, bool value) const;
+
+		std::size_t count_satisfying() const;
+
+		bool operator==(const TruthTable&) const;
+		std::size_t hash() const;
+
+		/*
+		 * W(a) = Σ (-1)^(f(x) ⊕ a·x) over every row x, computed with the fast Walsh-Hadamard transform
+		 * |W(a)| ≤ 2^n so the coefficients fit in 32 bits, the spectrum of 30 variables still takes 4 GiB
+		 */
+		std::vector<std::int32_t> walsh_spectrum() const;
+
+		/* true on exactly half of the rows */
+		bool is_balanced() const;
+		/* the largest m such that W(a) = 0 whenever a has between 1 and m bits set */
+		std::size_t correlation_immunity() const;
+		/* distance to the closest affine function */
+		std::size_t nonlinearity() const;
+
+		/* the same queries on a spectrum already computed by walsh_spectrum */
+		static std::size_t correlation_immunity(const std::vector<std::int32_t>& spectrum);
+		static std::size_t nonlinearity(const std::vector<std::int32_t>& spectrum);
+
+		friend std::ostream& operator<<(std::ostream&, const TruthTable&);
+	};
+}
+
+/* allow truth tables to be used as keys in unordered containers */
+template<>
+struct std::hash<logic::TruthTable> {
+	std::size_t operator()(const logic::TruthTable& table) const noexcept {
+		return table.hash();
+	}
+};
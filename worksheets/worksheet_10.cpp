@@ -0,0 +1,81 @@
+#include <iostream>
+#include "formula.hpp"
+#include "solver.hpp"
+#include <stdexcept>
+#include <vector>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+void show(const std::optional<Interpretation>& model) {
+	if (model.has_value()) {
+		std::cout << "satisfied by " << *model << std::endl;
+	} else {
+		std::cout << "unsatisfiable" << std::endl;
+	}
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s); VAR(t); VAR(u);
+
+	/* t and u only name intermediate results, so preprocessing can eliminate them */
+	auto phi = (t == (p and q)) and (u == (t or r)) and (u or s) and (not s or not p) and (not u or not q);
+
+	Solver solver;
+	solver.freeze("p");
+	solver.freeze("q");
+	solver.add(phi);
+	solver.preprocess();
+
+	/* eliminated variables are given a value again by reconstruction */
+	auto model = solver.solve();
+	show(model);
+	std::cout << phi.eval(*model) << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* frozen variables can still be assumed */
+	for (int row = 0; row < 4; row++) {
+		Interpretation I({ { "p", bool(row & 1) }, { "q", bool(row & 2) } });
+
+		std::cout << I << ": ";
+		show(solver.solve(I));
+		std::cout << (phi and Formula::Cube(I)).satisfiable_naive() << std::endl;
+	}
+
+	std::cout << "Question 3:" << std::endl;
+	/* and used in formulas added later */
+	solver.add(p or q);
+	model = solver.solve();
+	show(model);
+	std::cout << (phi and (p or q)).eval(*model) << std::endl;
+
+	/* but variables which weren't frozen may be gone */
+	try {
+		solver.add(not u);
+	} catch (const std::logic_error& e) {
+		std::cout << e.what() << std::endl;
+	}
+
+	std::cout << "Question 4:" << std::endl;
+	/* with every variable frozen the models can be counted through assumptions */
+	Solver counter;
+	for (const auto & name : phi.get_variables()) counter.freeze(name);
+	counter.add(phi);
+	counter.preprocess();
+
+	const auto & variables = phi.get_variables();
+	std::size_t count = 0;
+	for (std::size_t row = 0; row < (std::size_t(1) << variables.size()); row++) {
+		Interpretation I;
+		for (std::size_t i = 0; i < variables.size(); i++) {
+			I[variables[i]] = (row >> i) & 1;
+		}
+
+		count += counter.solve(I).has_value();
+	}
+
+	std::cout << count << " " << phi.count_satisfying() << std::endl;
+}
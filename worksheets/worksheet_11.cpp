@@ -0,0 +1,66 @@
+#include <iostream>
+#include "formula.hpp"
+#include "portfolio.hpp"
+#include <string>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+/* pigeon i sits in hole j */
+Formula sits(int i, int j) {
+	auto name = "x_" + std::to_string(i) + "_" + std::to_string(j);
+	return Formula::PropVar(name.c_str());
+}
+
+/* every one of the pigeons sits in some hole, and no two share one */
+Formula pigeonhole(int pigeons, int holes) {
+	auto phi = Formula::Tautology();
+	for (int i = 0; i < pigeons; i++) {
+		auto somewhere = Formula::Contradiction();
+		for (int j = 0; j < holes; j++) somewhere = somewhere or sits(i, j);
+		phi = phi and somewhere;
+	}
+
+	for (int j = 0; j < holes; j++) {
+		for (int i = 0; i < pigeons; i++) {
+			for (int k = i + 1; k < pigeons; k++) phi = phi and not (sits(i, j) and sits(k, j));
+		}
+	}
+
+	return phi;
+}
+
+void solve(const Formula& phi, PortfolioOptions options = {}) {
+	Portfolio portfolio(phi, options);
+	auto model = portfolio.solve();
+
+	std::cout << "winner: " << portfolio.get_winner() << std::endl;
+	if (model.has_value()) {
+		std::cout << "satisfied by " << *model << std::endl;
+		std::cout << phi.eval(*model) << std::endl;
+	} else {
+		std::cout << "unsatisfiable" << std::endl;
+	}
+	std::cout << phi.satisfiable_naive() << std::endl;
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r);
+
+	solve((p or q) and (not p or r) and (not q or not r));
+
+	std::cout << "Question 2:" << std::endl;
+	/* three pigeons don't fit into two holes - local search can't show it, a solver has to answer */
+	solve(pigeonhole(3, 2));
+
+	std::cout << "Question 3:" << std::endl;
+	/* but three fit into three, with every engine type racing */
+	solve(pigeonhole(3, 3), { .num_threads = 4, .local_search = true, .share_clauses = true });
+
+	std::cout << "Question 4:" << std::endl;
+	/* a single complete solver is a portfolio too */
+	solve(pigeonhole(4, 3), { .num_threads = 1, .local_search = false, .share_clauses = false });
+}
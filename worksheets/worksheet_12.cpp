@@ -0,0 +1,85 @@
+#include <iostream>
+#include "formula.hpp"
+#include "query.hpp"
+#include <chrono>
+#include <string>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+std::string describe(QueryStatus status) {
+	switch (status) {
+		case QueryStatus::complete:
+			return "complete";
+		case QueryStatus::timeout:
+			return "timeout";
+		case QueryStatus::budget_exhausted:
+			return "budget exhausted";
+		case QueryStatus::cancelled:
+			return "cancelled";
+	}
+
+	return "";
+}
+
+/* x_0 ⊕ ... ⊕ x_(n-1) - satisfied by exactly half of its 2^n interpretations */
+Formula parity(int n) {
+	auto phi = Formula::PropVar("x_0");
+	for (int i = 1; i < n; i++) {
+		auto name = "x_" + std::to_string(i);
+		phi = phi ^ Formula::PropVar(name.c_str());
+	}
+
+	return phi;
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r);
+
+	/* without limits a query runs to the end, like its blocking version */
+	auto expr = (p or q) and not r;
+	auto count = count_satisfying_async(expr).get();
+	std::cout << describe(count.status) << ": " << *count.value << " " << expr.count_satisfying() << std::endl;
+
+	auto tautology = is_tautology_async(p or not p).get();
+	std::cout << describe(tautology.status) << ": " << *tautology.value << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* the budget counts interpretations evaluated, what was seen so far is still reported */
+	QueryOptions budget;
+	budget.budget = 1000;
+
+	auto partial = count_satisfying_async(parity(40), budget).get();
+	std::cout << describe(partial.status) << ": " << partial.value.has_value() << std::endl;
+	std::cout << partial.satisfied << " of " << partial.evaluated << std::endl;
+
+	std::cout << "Question 3:" << std::endl;
+	/* 2^40 interpretations don't fit into a tenth of a second */
+	QueryOptions deadline;
+	deadline.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+
+	auto late = is_tautology_async(parity(40) or not parity(40), deadline).get();
+	std::cout << describe(late.status) << ": " << late.value.has_value() << std::endl;
+	std::cout << (late.evaluated > 0) << " " << late.last.has_value() << std::endl;
+
+	std::cout << "Question 4:" << std::endl;
+	/* dropping the handle of an unfinished query cancels it instead of waiting for the sweep */
+	CancellationToken token;
+	QueryOptions unbounded;
+	unbounded.token = token;
+
+	auto start = std::chrono::steady_clock::now();
+	{
+		auto query = count_satisfying_async(parity(40), unbounded);
+		std::cout << "finished: " << query.wait_for(std::chrono::milliseconds(10)) << std::endl;
+	}
+	std::cout << "dropped within a second: " << (std::chrono::steady_clock::now() - start < std::chrono::seconds(1)) << std::endl;
+
+	/* and the caller's token stops every query holding it */
+	auto query = count_satisfying_async(parity(40), unbounded);
+	token.cancel();
+	std::cout << describe(query.get().status) << std::endl;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include "formula.hpp"
+#include <unordered_set>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r);
+
+	/* valuations can be read and written by name */
+	Interpretation I({ { "p", true }, { "q", false } });
+	std::cout << I << " " << I.size() << std::endl;
+	std::cout << I.at("p") << " " << I.contains("r") << std::endl;
+
+	I["r"] = true;
+	I.flip("q");
+	std::cout << I << " " << I.count_satisfied() << std::endl;
+	std::cout << (p and q and r).eval(I) << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* or by VariableTable index, which is what the name based API does underneath */
+	auto index = VariableTable::intern("q");
+	I.set(index, false);
+	std::cout << I << " " << I.at(index) << std::endl;
+
+	I.erase(index);
+	std::cout << I << " " << I.contains(index) << " " << I.size() << std::endl;
+	std::cout << (p and q and r).eval_partial(I).has_value() << std::endl;
+
+	/* iteration visits the assigned variables only */
+	for (const auto & [name, valuation] : I) {
+		std::cout << name << " = " << valuation << std::endl;
+	}
+
+	std::cout << "Question 3:" << std::endl;
+	/* interpretations are equal when they assign the same, however they were built */
+	Interpretation J;
+	J["r"] = true;
+	J["p"] = true;
+	std::cout << (I == J) << " " << (I.hash() == J.hash()) << std::endl;
+
+	J.flip("p");
+	std::cout << (I == J) << std::endl;
+
+	/* so they can be collected without duplicates, even when every model is inserted twice */
+	std::unordered_set<Interpretation> seen;
+	auto phi = p or q or r;
+	for (int row = 0; row < 8; row++) {
+		Interpretation K({ { "p", bool(row & 1) }, { "q", bool(row & 2) }, { "r", bool(row & 4) } });
+		if (phi.eval(K)) {
+			seen.insert(K);
+			seen.insert(Interpretation({ { "r", bool(row & 4) }, { "q", bool(row & 2) }, { "p", bool(row & 1) } }));
+		}
+	}
+
+	std::cout << seen.size() << " " << phi.count_satisfying() << std::endl;
+}
@@ -0,0 +1,51 @@
+#include <iostream>
+#include "formula.hpp"
+#include "anf.hpp"
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+void show(const Formula& phi) {
+	ANF anf(phi);
+	std::cout << phi << " = " << anf << std::endl;
+	std::cout << "degree " << anf.degree() << ", affine " << anf.is_affine() << std::endl;
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r);
+
+	/* every formula is an XOR of conjunctions of its variables */
+	show(p and q);
+	show(p or q);
+	show(p.implies(q));
+	show((p and q) or (q and r) or (p and r));
+
+	std::cout << "Question 2:" << std::endl;
+	/* affine formulas have degree 1, whatever connectives they are written with */
+	show(p ^ q ^ r);
+	show((p or q) and not (p and q));
+	std::cout << (ANF(p ^ q ^ r) == ANF::parity({ "p", "q", "r" })) << std::endl;
+
+	/* built only from ¬, ↔ and ^ they are recognised without a truth table */
+	auto affine = ANF::affine_form(not (p == q) == r);
+	std::cout << affine.has_value() << " " << ANF::affine_form((p or q) and not (p and q)).has_value() << std::endl;
+	std::cout << affine->variables.size() << " " << affine->constant << std::endl;
+
+	/* a parity check is only true when an even number of its variables are */
+	std::cout << (not (p == q) == r).is_parity_check() << std::endl;
+	std::cout << (p ^ q ^ r).is_parity_check() << std::endl;
+	std::cout << (p and q).is_parity_check() << std::endl;
+	std::cout << (p or q).is_parity_check() << std::endl;
+
+	std::cout << "Question 3:" << std::endl;
+	/* ANFs over the same variables form a ring, ^ adds and * multiplies */
+	auto x = ANF(p or q or r);
+	auto y = ANF(p ^ (q and r));
+	std::cout << (x ^ y) << std::endl;
+	std::cout << (x * y) << std::endl;
+	std::cout << ((x ^ y) == ANF((p or q or r) ^ (p ^ (q and r)))) << std::endl;
+	std::cout << ((x * y) == ANF((p or q or r) and (p ^ (q and r)))) << std::endl;
+}
@@ -0,0 +1,61 @@
+#include <iostream>
+#include "formula.hpp"
+#include "truth_table.hpp"
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+void show(const Formula& phi) {
+	TruthTable table(phi);
+	auto spectrum = table.walsh_spectrum();
+
+	std::cout << phi << ":";
+	for (auto coefficient : spectrum) std::cout << " " << coefficient;
+	std::cout << std::endl;
+
+	std::cout << "balanced " << table.is_balanced()
+		<< ", correlation immunity " << TruthTable::correlation_immunity(spectrum)
+		<< ", nonlinearity " << TruthTable::nonlinearity(spectrum) << std::endl;
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s);
+
+	/* truth tables are packed 64 rows to a word */
+	TruthTable table((p or q) and not r);
+	std::cout << table << std::endl;
+	std::cout << table.count_satisfying() << " " << ((p or q) and not r).count_satisfying() << std::endl;
+
+	/* tables over different variables are extended to all of them before combining */
+	auto combined = table | TruthTable(s);
+	std::cout << combined.num_variables() << " " << (combined == TruthTable(((p or q) and not r) or s)) << std::endl;
+	std::cout << (table.cofactor("r", false) == TruthTable(p or q)) << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* W(0) is the number of falsifying rows less the number of satisfying ones */
+	show(p and q);
+	show(p ^ q);
+
+	/* a parity of every variable is uncorrelated with all but the full set of them */
+	show(p ^ q ^ r);
+
+	/* the bent function p∧q ⊕ r∧s has a flat spectrum, so it is as far from affine as possible */
+	show((p and q) ^ (r and s));
+
+	std::cout << "Question 3:" << std::endl;
+	/* the nonlinearity is the distance to the closest affine function, each linear one or its complement */
+	auto majority = (p and q) or (q and r) or (p and r);
+	std::size_t closest = 1 << 3;
+	for (auto affine : std::vector<Formula>{ Formula::Contradiction(), p, q, r, p ^ q, p ^ r, q ^ r, p ^ q ^ r }) {
+		closest = std::min(closest, (majority ^ affine).count_satisfying());
+		closest = std::min(closest, (majority == affine).count_satisfying());
+	}
+
+	std::cout << TruthTable(majority).nonlinearity() << " " << closest << std::endl;
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+#include "formula.hpp"
+#include "static_formula.hpp"
+#include <cstdint>
+#include <vector>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+namespace sf = logic::static_formula;
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	constexpr sf::Variable<0> a;
+	constexpr sf::Variable<1> b;
+	constexpr sf::Variable<2> c;
+
+	/* the structure of a static formula is its type, so it can be evaluated at compile time */
+	constexpr auto expr = (a or b).implies(a and not c);
+	static_assert(expr.eval(0b001));
+	static_assert(not expr.eval(0b010));
+	static_assert(decltype(expr)::num_variables == 3);
+
+	/* variable i reads bit i of the assignment */
+	for (std::uint64_t assignment = 0; assignment < 8; assignment++) {
+		std::cout << assignment << ": " << expr.eval(assignment) << std::endl;
+	}
+
+	std::cout << "Question 2:" << std::endl;
+	/* to_formula names the variables and gives the equivalent runtime formula */
+	VAR(p); VAR(q); VAR(r);
+	auto phi = expr.to_formula({ "p", "q", "r" });
+	std::cout << phi << std::endl;
+	std::cout << phi.semantically_equivalent_naive((p or q).implies(p and not r)) << std::endl;
+
+	std::cout << "Question 3:" << std::endl;
+	/* the truth table is one word, row r is bit r */
+	constexpr auto rows = expr.truth_table();
+	std::cout << std::hex << rows << std::dec << std::endl;
+
+	std::size_t count = 0;
+	for (std::size_t row = 0; row < 8; row++) count += (rows >> row) & 1;
+	std::cout << count << " " << phi.count_satisfying() << std::endl;
+
+	/* eval_parallel evaluates 64 assignments at once, one column per variable */
+	constexpr auto majority = (a and b) or (b and c) or (a and c);
+	std::vector<std::uint64_t> columns = { 0x00000000FFFFFFFF, 0x0000FFFF0000FFFF, 0x00FF00FF00FF00FF };
+	auto results = majority.eval_parallel(columns.data());
+	std::cout << std::hex << results << std::dec << std::endl;
+	std::cout << (results == ((columns[0] & columns[1]) | (columns[1] & columns[2]) | (columns[0] & columns[2]))) << std::endl;
+}
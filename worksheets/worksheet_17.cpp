@@ -0,0 +1,45 @@
+#include <iostream>
+#include "formula.hpp"
+#include <unordered_map>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s);
+
+	/* replace swaps a single variable for a formula, leaving the original alone */
+	auto phi = (p or q) and not r;
+	auto psi = phi.replace("p", r and s);
+	std::cout << phi << std::endl;
+	std::cout << psi << std::endl;
+
+	/* so replacing one variable after another chains the replacements */
+	std::cout << phi.replace("p", q).replace("q", p) << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* substitute replaces every variable at once, so p and q can be swapped */
+	auto swapped = phi.substitute({ { "p", q }, { "q", p } });
+	std::cout << swapped << std::endl;
+	std::cout << swapped.semantically_equivalent_naive(phi) << std::endl;
+
+	auto rotated = (p and not q).substitute({ { "p", q }, { "q", r }, { "r", p } });
+	std::cout << rotated << std::endl;
+
+	std::cout << "Question 3:" << std::endl;
+	/* constants can be substituted too, which fixes a variable without simplifying */
+	auto fixed = phi.substitute({ { "r", Formula::Contradiction() } });
+	std::cout << fixed << std::endl;
+	std::cout << fixed.semantically_equivalent_naive(p or q) << std::endl;
+	std::cout << phi.substitute({ { "p", Formula::Tautology() }, { "r", Formula::Contradiction() } }).is_tautology_naive() << std::endl;
+
+	/* the in-place variants change the formula itself */
+	auto chi = p.implies(q);
+	chi.replace_in_place("q", r or s);
+	std::cout << chi << std::endl;
+	chi.substitute_in_place({ { "r", s }, { "s", r } });
+	std::cout << chi << std::endl;
+}
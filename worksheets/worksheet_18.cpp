@@ -0,0 +1,50 @@
+#include <iostream>
+#include "formula.hpp"
+#include "allsat.hpp"
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s);
+
+	/* every model, each exactly once */
+	auto phi = (p or q) and (not p or r);
+	std::size_t count = 0;
+	for (const auto & model : ModelEnumerator(phi)) {
+		std::cout << model << " " << phi.eval(model) << std::endl;
+		count++;
+	}
+
+	std::cout << count << " " << phi.count_satisfying() << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* with a projection, the other variables are existentially quantified */
+	ModelEnumerator projected(phi, { .projection = { "p", "q" } });
+	while (auto model = projected.next()) {
+		std::cout << *model << " " << (phi and Formula::Cube(*model)).satisfiable_naive() << std::endl;
+	}
+
+	std::cout << "Question 3:" << std::endl;
+	/* partial models are cubes whose every extension is a model, so fewer are needed */
+	auto psi = p or (q and r and s);
+	ModelEnumerator cubes(psi, { .partial = true });
+	std::size_t covered = 0;
+	cubes.for_each([&](const Interpretation& cube) {
+		std::cout << cube << " " << (Formula::Cube(cube).implies(psi)).is_tautology_naive() << std::endl;
+		covered += std::size_t(1) << (psi.get_variables().size() - cube.size());
+		return true;
+	});
+
+	/* the cubes are disjoint, so together they cover each model once */
+	std::cout << covered << " " << psi.count_satisfying() << std::endl;
+
+	std::cout << "Question 4:" << std::endl;
+	/* for_each stops when visit returns false */
+	ModelEnumerator first(psi);
+	std::cout << first.for_each([](const Interpretation&) { return false; }) << std::endl;
+	std::cout << first.for_each([](const Interpretation&) { return true; }) + 1 << " " << psi.count_satisfying() << std::endl;
+}
@@ -0,0 +1,55 @@
+#include <iostream>
+#include "formula.hpp"
+#include "minimize.hpp"
+#include <string>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+Formula var(const std::string& name, int i) {
+	auto full = name + "_" + std::to_string(i);
+	return Formula::PropVar(full.c_str());
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s);
+
+	/* up to 12 variables the minimal form is found from the truth table */
+	auto phi = (p and q and r) or (p and q and not r) or (p and not q and r) or (not p and q and s);
+	auto dnf = minimize(phi);
+	auto cnf = minimize(phi, NormalForm::conjunctive);
+	std::cout << dnf << std::endl;
+	std::cout << cnf << std::endl;
+	std::cout << dnf.semantically_equivalent_naive(phi) << " " << cnf.semantically_equivalent_naive(phi) << std::endl;
+
+	/* constants come out as constants */
+	std::cout << minimize(p or not p) << " " << minimize(p and not p) << std::endl;
+
+	std::cout << "Question 2:" << std::endl;
+	/* beyond 12 variables Espresso is used - x_i ∧ y_i for each i, blown up with redundant cubes */
+	auto psi = Formula::Contradiction();
+	for (int i = 0; i < 8; i++) {
+		psi = psi or (var("x", i) and var("y", i));
+		psi = psi or (var("x", i) and var("y", i) and var("x", (i + 1) % 8));
+		psi = psi or (var("x", i) and var("y", i) and not var("y", (i + 1) % 8));
+	}
+
+	auto espresso = minimize(psi);
+	std::cout << psi.get_variables().size() << std::endl;
+	std::cout << espresso << std::endl;
+	std::cout << espresso.semantically_equivalent_naive(psi) << std::endl;
+
+	/* and the conjunctive form through the negation - x_i ∨ y_i for each i, with redundant clauses */
+	auto chi = Formula::Tautology();
+	for (int i = 0; i < 8; i++) {
+		chi = chi and (var("x", i) or var("y", i));
+		chi = chi and (var("x", i) or var("y", i) or var("y", (i + 1) % 8));
+	}
+
+	auto conjunctive = minimize(chi, NormalForm::conjunctive);
+	std::cout << conjunctive << std::endl;
+	std::cout << conjunctive.semantically_equivalent_naive(chi) << std::endl;
+}
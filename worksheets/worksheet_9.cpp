@@ -0,0 +1,78 @@
+#include <iostream>
+#include "formula.hpp"
+#include "solver.hpp"
+#include <vector>
+
+using namespace logic;
+
+#define VAR(x) logic::Formula x(#x)
+
+void show(const std::optional<Interpretation>& model) {
+	if (model.has_value()) {
+		std::cout << "satisfied by " << *model << std::endl;
+	} else {
+		std::cout << "unsatisfiable" << std::endl;
+	}
+}
+
+int main() {
+	std::cout << std::boolalpha;
+	std::cout << "Question 1:" << std::endl;
+	VAR(p); VAR(q); VAR(r); VAR(s);
+
+	auto phi = (p or q) and (not p or r) and (not q or s);
+	Solver solver(phi);
+
+	std::cout << phi << std::endl;
+	show(solver.solve());
+	std::cout << phi.satisfiable_naive() << std::endl;
+
+	/* formulas added inside a scope are retracted by pop */
+	solver.push();
+	solver.add(not r);
+	show(solver.solve());
+	std::cout << (phi and not r).satisfiable_naive() << std::endl;
+
+	solver.push();
+	solver.add(p);
+	show(solver.solve());
+	std::cout << (phi and not r and p).satisfiable_naive() << std::endl;
+	solver.pop();
+
+	show(solver.solve());
+	std::cout << (phi and not r).satisfiable_naive() << std::endl;
+	solver.pop();
+
+	show(solver.solve());
+
+	std::cout << "Question 2:" << std::endl;
+	Interpretation assumptions({
+		{ "p", true },
+		{ "q", false },
+		{ "r", false },
+		{ "s", true },
+	});
+
+	show(solver.solve(assumptions));
+	std::cout << (phi and Formula::Cube(assumptions)).satisfiable_naive() << std::endl;
+
+	/* a subset of the assumptions which can't hold together */
+	auto failed = solver.failed_assumptions();
+	std::cout << failed << std::endl;
+	std::cout << (phi and Formula::Cube(failed)).unsatisfiable_naive() << std::endl;
+
+	std::cout << "Question 3:" << std::endl;
+	/* count the models by solving under every full assignment */
+	std::vector<std::string> variables = { "p", "q", "r", "s" };
+	std::size_t count = 0;
+	for (std::size_t row = 0; row < (std::size_t(1) << variables.size()); row++) {
+		Interpretation I;
+		for (std::size_t i = 0; i < variables.size(); i++) {
+			I[variables[i]] = (row >> i) & 1;
+		}
+
+		count += solver.solve(I).has_value();
+	}
+
+	std::cout << count << " " << phi.count_satisfying() << std::endl;
+}